@@ -67,17 +67,17 @@ error_ptr stack_t::push(int value) noexcept
 // It is used to generate user friendly error messages.
 void print_stack_error(const error_ptr &err)
 {
-        if (!err) {
-                return;
-        }
-
-        if (!err.is<stack_error_t>()) {
+        // NOTE:
+        // errors::error_ptr::match examines the cause link list only once,
+        // no matter how many error types we are looking for.
+        auto matched = err.match<stack_error_t>();
+        if (matched.index() == 0) {
                 return;
         }
 
         std::cout << "Stack error occurs" << std::endl;
 
-        auto stack_error = err.as<stack_error_t>();
+        auto stack_error = std::get<1>(matched);
         assert(stack_error != nullptr);
 
         if (stack_error->top == 0) {
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <unistd.h>
+
+#include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// What ::errors::async_log::push does when the queue is full.
+enum class overflow_policy {
+        /// @brief
+        /// Drop the error and count it.
+        drop,
+        /// @brief
+        /// Wait until the background thread makes room.
+        block,
+};
+
+/// @brief
+/// Counters of an ::errors::async_log.
+struct async_log_stats {
+        /// @brief
+        /// The number of errors written.
+        std::uint64_t written;
+        /// @brief
+        /// The number of errors dropped because the queue was full.
+        std::uint64_t dropped;
+        /// @brief
+        /// The number of failed writes to the file descriptor,
+        /// each might lose many errors.
+        std::uint64_t failed;
+};
+
+/// @brief
+/// A log which formats and writes errors on a background thread.
+///
+/// @details
+/// ::errors::async_log::push moves the error into a bounded lock-free
+/// queue, which is all the calling thread pays for.
+/// The background thread formats queued errors by ::errors::format_to,
+/// one line each,
+/// and writes them to a file descriptor in batches.
+///
+/// Many threads can push at the same time.
+/// Errors pushed by one thread are written in order.
+/// Programs using it need to link the threads library,
+/// like `Threads::Threads` in CMake.
+///
+/// It writes by POSIX `write(2)`,
+/// so `errors/errors.hpp` only includes it
+/// where `<unistd.h>` is available.
+///
+/// @warning
+/// Errors are destroyed by the background thread,
+/// so they **MUST NOT** be allocated from a memory resource
+/// which is only safe to use from the thread which allocated them,
+/// see ::errors::memory_resource_scope.
+class async_log {
+    public:
+        /// @brief
+        /// Start a log.
+        ///
+        /// @param fd
+        /// The file descriptor, which is not closed by the log.
+        ///
+        /// @param capacity
+        /// The number of errors the queue can hold,
+        /// rounded up to a power of two.
+        ///
+        /// @param policy
+        /// What to do when the queue is full.
+        ///
+        /// @param style
+        /// The output format.
+        explicit async_log(int fd, std::size_t capacity = 4096,
+                           overflow_policy policy = overflow_policy::drop,
+                           format_style style = format_style::chain)
+                : fd(fd)
+                , policy(policy)
+                , style(style)
+                , mask(round_capacity(capacity) - 1)
+                , cells(std::make_unique<cell[]>(this->mask + 1))
+        {
+                for (std::size_t i = 0; i <= this->mask; ++i) {
+                        this->cells[i].sequence.store(
+                                i, std::memory_order_relaxed);
+                }
+                this->worker = std::thread([this]() { this->run(); });
+        }
+
+        async_log(const async_log &) = delete;
+        async_log(async_log &&) = delete;
+        async_log &operator=(const async_log &) = delete;
+        async_log &operator=(async_log &&) = delete;
+
+        /// @brief
+        /// Write all queued errors and stop the background thread.
+        ~async_log()
+        {
+                this->stopping.store(true, std::memory_order_seq_cst);
+                this->wake();
+                this->worker.join();
+        }
+
+        /// @brief
+        /// Queue an error to be written.
+        ///
+        /// @param err
+        /// The error chain, ignored if it is `nullptr`.
+        ///
+        /// @return
+        /// `false` if the error was dropped.
+        bool push(error_ptr &&err)
+        {
+                if (!err) {
+                        return true;
+                }
+
+                while (!this->try_push(err)) {
+                        if (this->policy == overflow_policy::drop) {
+                                this->dropped.fetch_add(
+                                        1, std::memory_order_relaxed);
+                                return false;
+                        }
+                        this->wake();
+                        std::this_thread::yield();
+                }
+
+                // NOTE:
+                // The sequence store in try_push and this load
+                // are both sequentially consistent,
+                // so either this sees the background thread sleeping
+                // or it sees the error before it sleeps.
+                if (this->sleeping.load(std::memory_order_seq_cst)) {
+                        this->wake();
+                }
+                return true;
+        }
+
+        /// @brief
+        /// Wait until errors queued before are written.
+        void flush()
+        {
+                auto target = this->tail.load(std::memory_order_acquire);
+                while (this->consumed.load(std::memory_order_acquire) <
+                       target) {
+                        this->wake();
+                        std::this_thread::yield();
+                }
+        }
+
+        /// @brief
+        /// Get the counters.
+        [[nodiscard]]
+        async_log_stats stats() const noexcept
+        {
+                return { this->written.load(std::memory_order_relaxed),
+                         this->dropped.load(std::memory_order_relaxed),
+                         this->failed.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        struct cell {
+                std::atomic<std::size_t> sequence{ 0 };
+                error_ptr err;
+        };
+
+        // NOTE:
+        // The number of errors formatted into one write.
+        static constexpr std::size_t batch_size = 64;
+
+        const int fd;
+        const overflow_policy policy;
+        const format_style style;
+        const std::size_t mask;
+        std::unique_ptr<cell[]> cells;
+
+        alignas(64) std::atomic<std::size_t> tail{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+
+        alignas(64) std::atomic<std::size_t> consumed{ 0 };
+        std::atomic<std::uint64_t> written{ 0 };
+        std::atomic<std::uint64_t> failed{ 0 };
+        std::atomic<bool> sleeping{ false };
+        std::atomic<bool> stopping{ false };
+
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::thread worker;
+
+        static std::size_t round_capacity(std::size_t capacity) noexcept
+        {
+                std::size_t result = 1;
+                while (result < capacity) {
+                        result <<= 1;
+                }
+                return result;
+        }
+
+        bool try_push(error_ptr &err) noexcept
+        {
+                // NOTE:
+                // A bounded queue by Dmitry Vyukov:
+                // each cell has a sequence number,
+                // which tells producers and the consumer
+                // whose turn it is.
+                auto position = this->tail.load(std::memory_order_relaxed);
+                cell *target = nullptr;
+                for (;;) {
+                        target = &this->cells[position & this->mask];
+                        auto sequence = target->sequence.load(
+                                std::memory_order_acquire);
+                        auto diff = static_cast<std::intptr_t>(sequence) -
+                                    static_cast<std::intptr_t>(position);
+                        if (diff == 0) {
+                                if (this->tail.compare_exchange_weak(
+                                            position, position + 1,
+                                            std::memory_order_relaxed)) {
+                                        break;
+                                }
+                        } else if (diff < 0) {
+                                return false;
+                        } else {
+                                position = this->tail.load(
+                                        std::memory_order_relaxed);
+                        }
+                }
+
+                target->err = std::move(err);
+                target->sequence.store(position + 1,
+                                       std::memory_order_seq_cst);
+                return true;
+        }
+
+        bool try_pop(std::size_t position, error_ptr &err) noexcept
+        {
+                auto &source = this->cells[position & this->mask];
+                if (source.sequence.load(std::memory_order_acquire) !=
+                    position + 1) {
+                        return false;
+                }
+                err = std::move(source.err);
+                source.sequence.store(position + this->mask + 1,
+                                      std::memory_order_release);
+                return true;
+        }
+
+        void wake()
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->wakeup.notify_one();
+        }
+
+        void sleep(std::size_t position)
+        {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->sleeping.store(true, std::memory_order_seq_cst);
+                auto &next = this->cells[position & this->mask];
+                if (next.sequence.load(std::memory_order_seq_cst) !=
+                            position + 1 &&
+                    !this->stopping.load(std::memory_order_seq_cst)) {
+                        this->wakeup.wait_for(lock,
+                                              std::chrono::milliseconds(100));
+                }
+                this->sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        void run()
+        {
+                std::string buffer;
+                std::size_t position = 0;
+                error_ptr err;
+                for (;;) {
+                        std::size_t count = 0;
+                        std::size_t formatted = 0;
+                        for (; count < batch_size &&
+                               this->try_pop(position, err);
+                             ++count, ++position) {
+                                if (this->format(buffer, err)) {
+                                        ++formatted;
+                                }
+                                err = nullptr;
+                        }
+
+                        if (count != 0) {
+                                this->write(buffer, formatted);
+                                buffer.clear();
+                                this->consumed.store(
+                                        position, std::memory_order_release);
+                                continue;
+                        }
+
+                        if (this->stopping.load(std::memory_order_seq_cst)) {
+                                // NOTE:
+                                // Producers have returned,
+                                // the queue is empty.
+                                return;
+                        }
+                        this->sleep(position);
+                }
+        }
+
+        bool format(std::string &buffer, const error_ptr &err) noexcept
+        {
+                auto size = buffer.size();
+                try {
+                        format_to(std::back_inserter(buffer), err,
+                                  this->style);
+                        buffer.push_back('\n');
+                        return true;
+                } catch (...) {
+                        // NOTE:
+                        // Out of memory, count it as a failed write
+                        // and drop the partial text of this error.
+                        buffer.resize(size);
+                        this->failed.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                }
+        }
+
+        void write(const std::string &buffer, std::size_t count) noexcept
+        {
+                const auto *data = buffer.data();
+                auto size = buffer.size();
+                while (size != 0) {
+                        auto result = ::write(this->fd, data, size);
+                        if (result < 0 && errno == EINTR) {
+                                continue;
+                        }
+                        if (result <= 0) {
+                                this->failed.fetch_add(
+                                        1, std::memory_order_relaxed);
+                                return;
+                        }
+                        data += result;
+                        size -= static_cast<std::size_t>(result);
+                }
+                this->written.fetch_add(count, std::memory_order_relaxed);
+        }
+};
+
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+
+#include "errors/detail/bounded_sink.hpp"
+#include "errors/error_ptr.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// The output used by formatting hooks of ::errors::chain_formatter.
+///
+/// @details
+/// It forwards pieces of text to the underlying output
+/// without copying them
+/// and counts the number of bytes written.
+class format_writer {
+    public:
+        /// @brief
+        /// Write to a sink.
+        ///
+        /// @param sink
+        /// A callable object taking `(const char *, std::size_t)`,
+        /// it **MUST** outlive this writer.
+        template <typename Sink>
+        explicit format_writer(Sink &sink) noexcept
+                : context(&sink)
+                , callback(&forward<Sink>)
+        {
+        }
+
+        /// @brief
+        /// Write a string.
+        void write(std::string_view str)
+        {
+                if (str.empty()) {
+                        return;
+                }
+                this->callback(this->context, str.data(), str.size());
+                this->length += str.size();
+        }
+
+        /// @brief
+        /// Write a character.
+        void write(char c)
+        {
+                this->write(std::string_view(&c, 1));
+        }
+
+        /// @brief
+        /// Write an integer in decimal.
+        template <typename Integer,
+                  typename = std::enable_if_t<
+                          std::is_integral_v<Integer> &&
+                          !std::is_same_v<Integer, bool> &&
+                          !std::is_same_v<Integer, char>>>
+        void write(Integer value)
+        {
+                char buffer[24];
+                auto result =
+                        std::to_chars(buffer, buffer + sizeof(buffer), value);
+                this->write(std::string_view(
+                        buffer, static_cast<std::size_t>(result.ptr - buffer)));
+        }
+
+        /// @brief
+        /// Get the number of bytes written.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->length;
+        }
+
+    private:
+        template <typename Sink>
+        static void forward(void *context, const char *data, std::size_t size)
+        {
+                (*static_cast<Sink *>(context))(data, size);
+        }
+
+        void *context;
+        void (*callback)(void *, const char *, std::size_t);
+        std::size_t length = 0;
+};
+
+/// @brief
+/// Format error chains with formatting hooks chosen per error type.
+///
+/// @details
+/// Each hook is a type like this:
+///
+/// ```cpp
+/// struct stack_error_format {
+///         using error_type = stack_error_t;
+///
+///         static void format(errors::format_writer &out,
+///                            const stack_error_t &err)
+///         {
+///                 out.write("stack error [top=");
+///                 out.write(err.top);
+///                 out.write(']');
+///         }
+/// };
+/// ```
+///
+/// Errors are joined by `": "` like the default `operator<<`.
+/// An error is written by the first hook
+/// whose `error_type` it can be referenced by,
+/// or by its message if there is no such hook.
+///
+/// The hook of a dynamic type is looked up only once per thread,
+/// by ::errors::error_ptr::as like checks on each hook in order.
+/// The index of the hook and the offset of `error_type` in the object
+/// are cached by `typeid`,
+/// later errors of the same type are dispatched
+/// through a table of functions generated from `Hooks`,
+/// without any `dynamic_cast`.
+///
+/// @tparam Hooks
+/// The formatting hooks.
+template <typename... Hooks>
+class chain_formatter {
+    public:
+        /// @brief
+        /// Get the length of the formatted error chain.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @return
+        /// The exact number of bytes written by format_to().
+        [[nodiscard]]
+        static std::size_t formatted_size(const error_ptr &err)
+        {
+                detail::bounded_sink sink(nullptr, 0);
+                format(sink, err.get());
+                return sink.size();
+        }
+
+        /// @brief
+        /// Format an error chain into a caller provided buffer.
+        ///
+        /// @details
+        /// Same as ::errors::format_to(char *, std::size_t,
+        /// const error_ptr &, format_style).
+        ///
+        /// @param buffer
+        /// The buffer, it can be `nullptr` if `size` is `0`.
+        ///
+        /// @param size
+        /// The size of the buffer.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @return
+        /// The length of the whole output.
+        static std::size_t format_to(char *buffer, std::size_t size,
+                                     const error_ptr &err)
+        {
+                detail::bounded_sink sink(buffer, size);
+                format(sink, err.get());
+                return sink.size();
+        }
+
+        /// @brief
+        /// Append a formatted error chain to a string.
+        ///
+        /// @param out
+        /// The string to append to.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @return
+        /// The number of bytes appended.
+        static std::size_t format_to(std::string &out, const error_ptr &err)
+        {
+                auto sink = [&out](const char *data, std::size_t size) {
+                        out.append(data, size);
+                };
+                auto offset = out.size();
+                format(sink, err.get());
+                return out.size() - offset;
+        }
+
+        /// @brief
+        /// Write a formatted error chain to an output iterator.
+        ///
+        /// @param out
+        /// The output iterator of `char`.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @return
+        /// The iterator past the last character written.
+        template <typename OutputIt>
+        static OutputIt format_to(OutputIt out, const error_ptr &err)
+        {
+                auto sink = [&out](const char *data, std::size_t size) {
+                        out = std::copy(data, data + size, out);
+                };
+                format(sink, err.get());
+                return out;
+        }
+
+    private:
+        using hook_t = void (*)(format_writer &, const error *,
+                                std::ptrdiff_t);
+
+        struct entry_t {
+                const std::type_info *type;
+                std::size_t index;
+                std::ptrdiff_t offset;
+                bool reference;
+        };
+
+        static void write_message(format_writer &out, const error *err,
+                                  std::ptrdiff_t)
+        {
+                out.write(std::string_view(err->what()));
+        }
+
+        template <typename Hook>
+        static void call(format_writer &out, const error *err,
+                         std::ptrdiff_t offset)
+        {
+                // NOTE:
+                // Objects of the same dynamic type share the same layout,
+                // so the offset found by the first lookup
+                // is valid for all of them.
+                using E = typename Hook::error_type;
+                Hook::format(out, *reinterpret_cast<const E *>(
+                                          reinterpret_cast<const char *>(err) +
+                                          offset));
+        }
+
+        static constexpr std::array<hook_t, sizeof...(Hooks) + 1> hooks = {
+                &write_message, &call<Hooks>...
+        };
+
+        template <std::size_t I, typename Hook, typename... Rest>
+        static entry_t resolve(const error *err, const std::type_info &type)
+        {
+                const auto *found =
+                        detail::cast<typename Hook::error_type>(err);
+                if (found != nullptr) {
+                        return { &type, I,
+                                 reinterpret_cast<const char *>(found) -
+                                         reinterpret_cast<const char *>(
+                                                 err),
+                                 false };
+                }
+                if constexpr (sizeof...(Rest) != 0) {
+                        return resolve<I + 1, Rest...>(err, type);
+                } else {
+                        return { &type, 0, 0, false };
+                }
+        }
+
+        static const entry_t &lookup(const error *err)
+        {
+                constexpr std::size_t size = 32;
+                thread_local std::array<entry_t, size> cache = {};
+
+                const auto &type = typeid(*err);
+                auto key = reinterpret_cast<std::uintptr_t>(&type);
+                auto &entry = cache[(key ^ (key >> 5)) % size];
+                if (entry.type != &type) {
+                        if (detail::referenced_of(err) != err) {
+                                entry = { &type, 0, 0, true };
+                        } else if constexpr (sizeof...(Hooks) != 0) {
+                                entry = resolve<1, Hooks...>(err, type);
+                        } else {
+                                entry = { &type, 0, 0, false };
+                        }
+                }
+                return entry;
+        }
+
+        template <typename Sink>
+        static void format(Sink &sink, const error *err)
+        {
+                if (err == nullptr) {
+                        sink("no error", sizeof("no error") - 1);
+                        return;
+                }
+
+                // NOTE:
+                // Keep the same separators as the default operator<<.
+                bool printed = false;
+                for (; err != nullptr; err = err->cause().get()) {
+                        if (printed) {
+                                sink(": ", 2);
+                                printed = false;
+                        }
+
+                        // NOTE:
+                        // The offset is only valid for the referred error,
+                        // not for impl::shared_reference_error.
+                        const auto *target = err;
+                        const auto *entry = &lookup(target);
+                        while (entry->reference) {
+                                target = detail::referenced_of(target);
+                                entry = &lookup(target);
+                        }
+
+                        format_writer out(sink);
+                        hooks[entry->index](out, target, entry->offset);
+                        printed = out.size() != 0;
+                }
+        }
+};
+
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "errors/cloneable.hpp"
+#include "errors/error_ptr.hpp"
+#include "errors/impl/runtime_error.hpp"
+#include "errors/impl/wrap_error.hpp"
+#include "errors/memory_resource.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+namespace detail
+{
+
+/// @cond
+inline constexpr std::size_t arena_granularity = alignof(std::max_align_t);
+
+constexpr std::size_t arena_round(std::size_t size) noexcept
+{
+        return (size + arena_granularity - 1) / arena_granularity *
+               arena_granularity;
+}
+
+class clone_arena final : public std::pmr::memory_resource {
+    public:
+        static clone_arena *create(std::size_t capacity)
+        {
+                constexpr auto self = arena_round(sizeof(clone_arena));
+                auto *storage = static_cast<char *>(
+                        ::operator new(self + capacity));
+                return new (storage) clone_arena(storage + self, capacity);
+        }
+
+        void release() noexcept
+        {
+                if (this->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        this->destroy();
+                }
+        }
+
+    private:
+        clone_arena(char *begin, std::size_t capacity) noexcept
+                : next(begin)
+                , end(begin + capacity)
+        {
+        }
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+                void *result = nullptr;
+                auto size = arena_round(bytes);
+                if (alignment <= arena_granularity &&
+                    size <= static_cast<std::size_t>(this->end - this->next)) {
+                        result = this->next;
+                        this->next += size;
+                } else {
+                        // NOTE:
+                        // Only a clone which allocates more
+                        // than its clone_size gets here.
+                        result = ::operator new(
+                                bytes, std::align_val_t(alignment));
+                }
+                this->live.fetch_add(1, std::memory_order_relaxed);
+                return result;
+        }
+
+        void do_deallocate(void *p, std::size_t bytes,
+                           std::size_t alignment) override
+        {
+                auto *begin = reinterpret_cast<char *>(this) +
+                              arena_round(sizeof(clone_arena));
+                if (p < begin || p >= this->end) {
+                        ::operator delete(p, bytes,
+                                          std::align_val_t(alignment));
+                }
+                this->release();
+        }
+
+        bool do_is_equal(
+                const std::pmr::memory_resource &other) const noexcept override
+        {
+                return this == &other;
+        }
+
+        void destroy() noexcept
+        {
+                auto *storage = reinterpret_cast<char *>(this);
+                this->~clone_arena();
+                ::operator delete(storage);
+        }
+
+        char *next;
+        char *end;
+        // NOTE:
+        // One reference is held by the cloner until it is done,
+        // each error allocated holds another one,
+        // and errors of a chain can be destroyed by different threads
+        // once their causes are moved out.
+        std::atomic<std::size_t> live{ 1 };
+};
+
+class chain_cloner {
+    public:
+        error_ptr clone(const error *err)
+        {
+                std::size_t depth = 0;
+                std::size_t capacity = 0;
+                for (; err != nullptr; err = err->cause().get()) {
+                        // NOTE:
+                        // Clone what a shared error refers to,
+                        // not the reference.
+                        err = referenced_of(err);
+                        this->push(depth++, err);
+                        capacity += arena_round(size_of(err));
+                }
+                if (depth == 0) {
+                        return nullptr;
+                }
+
+                auto *arena = clone_arena::create(capacity);
+                struct guard {
+                        clone_arena *arena;
+                        ~guard()
+                        {
+                                this->arena->release();
+                        }
+                } hold{ arena };
+
+                error_ptr result;
+                while (depth != 0) {
+                        result = clone_one(arena, this->at(--depth),
+                                           std::move(result));
+                }
+                return result;
+        }
+
+    private:
+        static constexpr std::size_t inline_depth = 32;
+
+        std::array<const error *, inline_depth> stack;
+        std::vector<const error *> spilled;
+
+        static std::size_t size_of(const error *err) noexcept
+        {
+                auto size = err->clone_size();
+                if (size != 0) {
+                        return size;
+                }
+                return err->cause().get() == nullptr
+                               ? allocation_size<impl::runtime_error>()
+                               : allocation_size<impl::wrap_error>();
+        }
+
+        static error_ptr clone_one(clone_arena *arena, const error *err,
+                                   error_ptr &&cause)
+        {
+                if (err->clone_size() != 0) {
+                        return err->clone(arena, std::move(cause));
+                }
+
+                // NOTE:
+                // Keep the message and the source location
+                // of an error which can not be cloned.
+                auto location = err->location().value_or(source_location());
+                if (cause == nullptr) {
+                        return allocate<impl::runtime_error>(
+                                arena, err->what(), std::move(location));
+                }
+                return allocate<impl::wrap_error>(arena,
+                                                  std::string(err->what()),
+                                                  std::move(cause),
+                                                  std::move(location));
+        }
+
+        void push(std::size_t index, const error *err)
+        {
+                if (index < inline_depth) {
+                        this->stack[index] = err;
+                        return;
+                }
+                this->spilled.push_back(err);
+        }
+
+        const error *at(std::size_t index) const noexcept
+        {
+                if (index < inline_depth) {
+                        return this->stack[index];
+                }
+                return this->spilled[index - inline_depth];
+        }
+};
+/// @endcond
+
+}
+
+/// @brief
+/// Copy an error chain.
+///
+/// @details
+/// All errors of the copy are allocated from one block of memory,
+/// so the copy is made with a single allocation
+/// and its errors are next to each other.
+/// The block is freed when the last error of the copy is destroyed.
+///
+/// Errors are copied by ::errors::error::clone,
+/// see ::ERRORS_CLONEABLE.
+/// An error which can not be cloned is copied as
+/// an ::errors::impl::runtime_error without a cause,
+/// or an ::errors::impl::wrap_error with a cause,
+/// keeping its message and source location.
+/// Errors referred by ::errors::basic_shared_error
+/// are copied instead of the references.
+///
+/// @note
+/// Messages longer than
+/// ::errors::impl::inline_message::inline_capacity
+/// are still allocated by `new`,
+/// messages from ::errors::literal are not copied.
+///
+/// @param err
+/// The error chain.
+///
+/// @return
+/// The copy, or `nullptr` if `err` is `nullptr`.
+[[nodiscard]]
+inline error_ptr clone(const error_ptr &err)
+{
+        return detail::chain_cloner().clone(err.get());
+}
+
+}
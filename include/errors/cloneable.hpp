@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory_resource>
+#include <typeinfo>
+#include <utility>
+
+#include "errors/error_ptr.hpp"
+#include "errors/memory_resource.hpp"
+
+/// @brief
+/// Allow an error type to be copied by ::errors::clone.
+///
+/// @details
+/// Use this macro in the class body of an error type like this:
+///
+/// ```cpp
+/// class my_error : public errors::impl::runtime_error {
+///         ERRORS_CLONEABLE(my_error);
+///
+///     public:
+///         my_error(const my_error &other, errors::error_ptr &&cause)
+///                 : runtime_error(other, std::move(cause))
+///                 , value(other.value)
+///         {
+///         }
+///
+///         // ...
+/// };
+/// ```
+///
+/// The type must have a public constructor
+/// taking the error to copy and the copy of its cause,
+/// which is always `nullptr` for errors without a cause.
+/// Builtin error types have such constructors.
+///
+/// A type derived from a cloneable type
+/// without using this macro itself is not cloneable,
+/// so it is never sliced by ::errors::clone.
+///
+/// @note
+/// This macro leaves the access specifier as `public`.
+#define ERRORS_CLONEABLE(type)                                               \
+    public:                                                                  \
+        [[nodiscard]]                                                        \
+        std::size_t clone_size() const noexcept override                     \
+        {                                                                    \
+                return typeid(*this) == typeid(type)                         \
+                               ? ::errors::detail::allocation_size<type>()   \
+                               : 0;                                          \
+        }                                                                    \
+        [[nodiscard]]                                                        \
+        ::errors::error_ptr clone(                                           \
+                std::pmr::memory_resource *resource,                         \
+                ::errors::error_ptr &&cause) const override                  \
+        {                                                                    \
+                return ::errors::detail::allocate<type>(resource, *this,     \
+                                                        std::move(cause));   \
+        }                                                                    \
+        using errors_cloneable_type = type
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace errors
+{
+namespace detail
+{
+
+/// @brief
+/// A sink writing to a fixed size buffer.
+///
+/// @details
+/// Output beyond the end of the buffer is dropped but still counted,
+/// so a sink without buffer measures the length of the output.
+class bounded_sink {
+    public:
+        bounded_sink(char *buffer, std::size_t size) noexcept
+                : buffer(buffer)
+                , capacity(size)
+        {
+        }
+
+        void operator()(const char *data, std::size_t size) noexcept
+        {
+                if (this->length < this->capacity) {
+                        auto count =
+                                std::min(size, this->capacity - this->length);
+                        std::memcpy(this->buffer + this->length, data, count);
+                }
+                this->length += size;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->length;
+        }
+
+    private:
+        char *buffer;
+        std::size_t capacity;
+        std::size_t length = 0;
+};
+
+}
+}
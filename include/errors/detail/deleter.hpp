@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "errors/error.hpp"
+
+namespace errors
+{
+namespace detail
+{
+
+/// @brief
+/// Bookkeeping placed right before an error
+/// allocated from a `std::pmr::memory_resource`.
+///
+/// @details
+/// It records everything needed to give the storage back to the resource,
+/// so ::errors::detail::deleter only have to carry the resource pointer.
+struct allocation_header {
+        /// @brief
+        /// Size of the whole storage, including this header.
+        std::size_t size;
+        /// @brief
+        /// Alignment of the whole storage.
+        std::size_t alignment;
+        /// @brief
+        /// Offset from the beginning of the storage to the error.
+        std::size_t offset;
+};
+
+/// @brief
+/// The deleter of ::errors::error_ptr.
+///
+/// @details
+/// An error allocated by `new` is deleted by `delete`.
+/// An error allocated from a `std::pmr::memory_resource`
+/// is destroyed in place and its storage is given back to that resource.
+///
+/// As it carries the resource,
+/// a pointer released from ::errors::error_ptr
+/// has to be given back to its deleter instead of `delete`.
+class deleter {
+    public:
+        constexpr deleter() noexcept = default;
+
+        /// @brief
+        /// Allow ::errors::error_ptr to take the ownership
+        /// from a `std::unique_ptr` with the default deleter.
+        template <typename E>
+        constexpr deleter(const std::default_delete<E> &) noexcept
+        {
+        }
+
+        /// @brief
+        /// Create a deleter for errors allocated from `resource`.
+        ///
+        /// @param resource
+        /// The memory resource which the error was allocated from.
+        explicit constexpr deleter(std::pmr::memory_resource *resource) noexcept
+                : resource_(resource)
+        {
+        }
+
+        void operator()(error *err) const noexcept
+        {
+                if (this->resource_ == nullptr) {
+                        delete err;
+                        return;
+                }
+
+                auto *object = static_cast<char *>(dynamic_cast<void *>(err));
+                auto header =
+                        *(reinterpret_cast<allocation_header *>(object) - 1);
+
+                err->~error();
+
+                this->resource_->deallocate(object - header.offset,
+                                            header.size, header.alignment);
+        }
+
+        /// @brief
+        /// Get the memory resource which the error was allocated from.
+        ///
+        /// @return
+        /// The memory resource,
+        /// or `nullptr` if the error was allocated by `new`.
+        [[nodiscard]]
+        constexpr std::pmr::memory_resource *resource() const noexcept
+        {
+                return this->resource_;
+        }
+
+    private:
+        std::pmr::memory_resource *resource_ = nullptr;
+};
+
+}
+}
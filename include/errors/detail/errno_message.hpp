@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace errors
+{
+namespace detail
+{
+
+/// @cond
+inline const char *strerror_result(int result, const char *buffer) noexcept
+{
+        return result == 0 ? buffer : nullptr;
+}
+
+inline const char *strerror_result(const char *result, const char *) noexcept
+{
+        return result;
+}
+/// @endcond
+
+/// @brief
+/// Get the message of an error number like `strerror`,
+/// but in a thread-safe way.
+///
+/// @details
+/// Both the XSI and the GNU variants of `strerror_r` are supported,
+/// and `strerror_s` is used on Windows.
+/// Other platforms fall back to `std::strerror`,
+/// which might not be thread-safe there.
+///
+/// @param code
+/// The error number.
+///
+/// @return
+/// The message.
+[[nodiscard]]
+inline std::string strerror_string(int code)
+{
+        char buffer[256] = {};
+#if defined(_WIN32)
+        const auto *text = strerror_result(
+                strerror_s(buffer, sizeof(buffer), code), buffer);
+#elif defined(__unix__) || defined(__APPLE__)
+        const auto *text = strerror_result(
+                strerror_r(code, buffer, sizeof(buffer)), buffer);
+#else
+        const auto *text = std::strerror(code);
+#endif
+        if (text == nullptr) {
+                return "Unknown error " + std::to_string(code);
+        }
+        return text;
+}
+
+/// @brief
+/// A table of the messages of common error numbers.
+///
+/// @details
+/// Each message is looked up once,
+/// when its error number is used for the first time,
+/// and kept until the process exits,
+/// so looking up a message is safe from any thread
+/// and calls `strerror` at most once for each error number.
+///
+/// @note
+/// The messages follow the locale
+/// at the time they are looked up.
+class errno_messages {
+    public:
+        /// @brief
+        /// Error numbers in `[0, size)` are kept in the table.
+        static constexpr int size = 256;
+
+        /// @brief
+        /// Get the table.
+        [[nodiscard]]
+        static const errno_messages &instance() noexcept
+        {
+                // NOTE:
+                // The table is constant-initialized to null entries,
+                // so no guard is needed.
+                static const errno_messages messages;
+                return messages;
+        }
+
+        /// @brief
+        /// Look up the message of an error number.
+        ///
+        /// @param code
+        /// The error number.
+        ///
+        /// @return
+        /// The message,
+        /// or an empty string if `code` is not in the table.
+        [[nodiscard]]
+        std::string_view find(int code) const
+        {
+                if (code < 0 || code >= size) {
+                        return {};
+                }
+
+                auto &entry = this->messages[static_cast<std::size_t>(code)];
+                const auto *message = entry.load(std::memory_order_acquire);
+                if (message != nullptr) {
+                        return *message;
+                }
+
+                // NOTE:
+                // Threads racing here look up the same message,
+                // the first one to publish it wins.
+                auto *created = new std::string(strerror_string(code));
+                if (entry.compare_exchange_strong(message, created,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                        return *created;
+                }
+                delete created;
+                return *message;
+        }
+
+    private:
+        constexpr errno_messages() noexcept = default;
+
+        mutable std::array<std::atomic<const std::string *>, size> messages{};
+};
+
+/// @brief
+/// Append the message of an error number to a string.
+///
+/// @param out
+/// The string to append to.
+///
+/// @param code
+/// The error number.
+inline void append_errno_message(std::string &out, int code)
+{
+        auto message = errno_messages::instance().find(code);
+        if (message.empty()) {
+                out += strerror_string(code);
+                return;
+        }
+        out += message;
+}
+
+}
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <memory_resource>
 #include <optional>
 
 #include "errors/detail/interface.hpp"
+#include "errors/type_id.hpp"
 
 namespace errors
 {
@@ -74,6 +77,69 @@ class error : public virtual detail::interface {
         /// if it is available.
         [[nodiscard]]
         virtual std::optional<source_location> location() const noexcept = 0;
+        /// @brief
+        /// Get this error as the error type identified by `id`.
+        ///
+        /// @param id
+        /// The identity of an error type
+        /// registered by ::ERRORS_REGISTER_TYPE.
+        ///
+        /// @return
+        /// A pointer to the subobject of that type,
+        /// which should be `static_cast` to that type,
+        /// or `nullptr` if this error is not an instance of that type.
+        ///
+        /// @details
+        ///
+        /// You should not override this method manually,
+        /// use ::ERRORS_REGISTER_TYPE instead.
+        [[nodiscard]]
+        virtual const void *cast(type_id id) const noexcept
+        {
+                static_cast<void>(id);
+                return nullptr;
+        }
+
+        /// @brief
+        /// Get the size of the storage needed by ::errors::error::clone.
+        ///
+        /// @return
+        /// The number of bytes requested from the memory resource
+        /// by ::errors::error::clone,
+        /// or `0` if this error can not be cloned.
+        ///
+        /// @details
+        ///
+        /// You should not override this method manually,
+        /// use ::ERRORS_CLONEABLE instead.
+        [[nodiscard]]
+        virtual std::size_t clone_size() const noexcept
+        {
+                return 0;
+        }
+
+        /// @brief
+        /// Copy this error, without its cause.
+        ///
+        /// @param resource
+        /// The memory resource to allocate the copy from,
+        /// `nullptr` means allocating it by `new`.
+        ///
+        /// @param cause
+        /// The cause of the copy.
+        ///
+        /// @return
+        /// The copy, which releases its storage to `resource`,
+        /// or `nullptr` if this error can not be cloned.
+        ///
+        /// @details
+        ///
+        /// You should not override this method manually,
+        /// use ::ERRORS_CLONEABLE instead.
+        /// Use ::errors::clone to copy a whole chain.
+        [[nodiscard]]
+        virtual error_ptr clone(std::pmr::memory_resource *resource,
+                                error_ptr &&cause) const;
 };
 static_assert(std::is_abstract<error>());
 }
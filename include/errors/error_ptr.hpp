@@ -1,18 +1,94 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <utility>
+#include <variant>
+#include <vector>
 
+#include "errors/detail/deleter.hpp"
 #include "errors/error.hpp"
 
 namespace errors
 {
 
+namespace detail
+{
+/// @cond
+struct shared_reference_tag;
+struct joined_causes_tag;
+
+inline const error *referenced_of(const error *err) noexcept
+{
+        const auto *target = err->cast(type_id_of<shared_reference_tag>());
+        return target == nullptr ? err : static_cast<const error *>(target);
+}
+
+template <typename E>
+const E *cast(const error *err) noexcept
+{
+        static_assert(std::is_base_of_v<error, E>);
+
+        if constexpr (is_registered_v<E>) {
+                return static_cast<const E *>(err->cast(type_id_of<E>()));
+        } else {
+                const auto *result = dynamic_cast<const E *>(err);
+                if (result != nullptr) {
+                        return result;
+                }
+
+                // NOTE:
+                // Registered types are forwarded by the virtual cast
+                // of impl::shared_reference_error,
+                // look through it for the others.
+                const auto *target = referenced_of(err);
+                return target == err ? nullptr : cast<E>(target);
+        }
+}
+
+template <typename E>
+const E *find(const error *err) noexcept;
+
+template <typename... E, std::size_t... I>
+std::variant<std::monostate, const E *...>
+match(const error *err, bool innermost, std::index_sequence<I...>) noexcept;
+/// @endcond
+}
+
 /// @brief
 /// Smart pointer to ::errors::error with some utility member functions
-class error_ptr : public std::unique_ptr<error> {
+///
+/// @details
+/// The error might be allocated by `new`
+/// or from a `std::pmr::memory_resource`,
+/// see ::errors::memory_resource_scope.
+/// The deleter remembers which one,
+/// so this pointer is as large as two raw pointers.
+///
+/// @warning
+/// An error taken by `release` **MUST** be destroyed
+/// by the deleter returned by `get_deleter` before releasing it,
+/// `delete` is only right for errors allocated by `new`.
+class error_ptr : public std::unique_ptr<error, detail::deleter> {
     public:
-        using std::unique_ptr<error>::unique_ptr;
+        using std::unique_ptr<error, detail::deleter>::unique_ptr;
+
+        /// @brief
+        /// Replace the error with one allocated by `new`.
+        ///
+        /// @details
+        /// Unlike `std::unique_ptr::reset`,
+        /// the deleter is replaced as well,
+        /// so `err` is deleted by `delete`
+        /// whichever memory resource the previous error came from.
+        ///
+        /// @param err
+        /// An error allocated by `new`, or `nullptr`.
+        void reset(error *err = nullptr) noexcept
+        {
+                std::unique_ptr<error, detail::deleter>::reset(err);
+                this->get_deleter() = detail::deleter();
+        }
 
         /// @brief
         /// Check if the error is caused by
@@ -22,21 +98,14 @@ class error_ptr : public std::unique_ptr<error> {
         /// @return
         /// `true` if the error is caused by an instance of error `E`,
         /// `false` otherwise.
+        /// @details
+        /// If `E` is registered by ::ERRORS_REGISTER_TYPE,
+        /// no `dynamic_cast` is performed.
         template <typename E>
         [[nodiscard]]
         bool is() const
         {
-                static_assert(std::is_base_of_v<error, E>);
-
-                auto current = this->get();
-                while (current != nullptr) {
-                        if (dynamic_cast<const E *>(current) != nullptr) {
-                                return true;
-                        }
-
-                        current = current->cause().get();
-                }
-                return false;
+                return detail::find<E>(this->get()) != nullptr;
         }
 
         /// @brief
@@ -49,22 +118,13 @@ class error_ptr : public std::unique_ptr<error> {
         /// @details
         /// Examines the cause link list, looking for the first error
         /// which can be referenced by `E`.
+        /// If `E` is registered by ::ERRORS_REGISTER_TYPE,
+        /// no `dynamic_cast` is performed.
         template <typename E>
         [[nodiscard]]
         const E *as() const
         {
-                static_assert(std::is_base_of_v<error, E>);
-
-                auto current = this->get();
-                while (current != nullptr) {
-                        auto result = dynamic_cast<const E *>(current);
-                        if (result != nullptr) {
-                                return result;
-                        }
-
-                        current = current->cause().get();
-                }
-                return nullptr;
+                return detail::find<E>(this->get());
         }
 
         /// @copydoc as() const
@@ -74,8 +134,155 @@ class error_ptr : public std::unique_ptr<error> {
         {
                 return const_cast<E *>(std::as_const(*this).as<E>());
         }
+
+        /// @brief
+        /// Looking up errors of several types in causes at once.
+        /// @tparam E
+        /// Types of error to looking for.
+        /// @return
+        /// A variant holds a pointer to the first error in the cause link list
+        /// which can be referenced by one of `E`,
+        /// or `std::monostate` if there is no such error.
+        /// The index of the variant is the index of that type in `E` plus one.
+        /// @details
+        /// Unlike calling as() for each type,
+        /// the cause link list is examined only once.
+        /// If an error can be referenced by more than one of `E`,
+        /// the first one of them is chosen.
+        template <typename... E>
+        [[nodiscard]]
+        std::variant<std::monostate, const E *...> match() const
+        {
+                return detail::match<E...>(this->get(), false,
+                                           std::index_sequence_for<E...>());
+        }
+
+        /// @brief
+        /// Looking up the innermost error of several types in causes at once.
+        /// @tparam E
+        /// Types of error to looking for.
+        /// @return
+        /// Same as match(),
+        /// but holds a pointer to the last error in the cause link list
+        /// which can be referenced by one of `E`.
+        template <typename... E>
+        [[nodiscard]]
+        std::variant<std::monostate, const E *...> match_innermost() const
+        {
+                return detail::match<E...>(this->get(), true,
+                                           std::index_sequence_for<E...>());
+        }
 };
 static_assert(!std::is_abstract<error_ptr>());
+
+inline error_ptr error::clone(std::pmr::memory_resource *resource,
+                              error_ptr &&cause) const
+{
+        static_cast<void>(resource);
+        static_cast<void>(cause);
+        return nullptr;
+}
+
+namespace detail
+{
+/// @brief
+/// Get the causes of an error besides ::errors::error::cause,
+/// see ::errors::impl::joined_error.
+///
+/// @return
+/// The causes,
+/// or `nullptr` if the error has no more causes.
+inline const std::vector<error_ptr> *causes_of(const error *err) noexcept
+{
+        return static_cast<const std::vector<error_ptr> *>(
+                err->cast(type_id_of<joined_causes_tag>()));
+}
+
+/// @cond
+template <typename E>
+const E *find(const error *err) noexcept
+{
+        while (err != nullptr) {
+                auto result = cast<E>(err);
+                if (result != nullptr) {
+                        return result;
+                }
+
+                const auto *next = err->cause().get();
+                if (next == nullptr) {
+                        // NOTE:
+                        // Only the end of a chain can have more causes,
+                        // search them depth first.
+                        const auto *causes = causes_of(err);
+                        if (causes == nullptr) {
+                                return nullptr;
+                        }
+                        for (const auto &cause : *causes) {
+                                result = find<E>(cause.get());
+                                if (result != nullptr) {
+                                        return result;
+                                }
+                        }
+                        return nullptr;
+                }
+                err = next;
+        }
+        return nullptr;
+}
+
+template <std::size_t I, typename E, typename Result>
+bool match_one(const error *err, Result &result) noexcept
+{
+        auto matched = cast<E>(err);
+        if (matched == nullptr) {
+                return false;
+        }
+
+        result.template emplace<I>(matched);
+        return true;
+}
+
+template <typename... E, typename Result, std::size_t... I>
+bool match_tree(const error *err, bool innermost, Result &result,
+                std::index_sequence<I...> indexes) noexcept
+{
+        while (err != nullptr) {
+                auto matched = (match_one<I + 1, E>(err, result) || ...);
+                if (matched && !innermost) {
+                        return true;
+                }
+
+                const auto *next = err->cause().get();
+                if (next == nullptr) {
+                        const auto *causes = causes_of(err);
+                        if (causes == nullptr) {
+                                return false;
+                        }
+                        for (const auto &cause : *causes) {
+                                if (match_tree<E...>(cause.get(), innermost,
+                                                     result, indexes)) {
+                                        return true;
+                                }
+                        }
+                        return false;
+                }
+                err = next;
+        }
+        return false;
+}
+
+template <typename... E, std::size_t... I>
+std::variant<std::monostate, const E *...>
+match(const error *err, bool innermost,
+      std::index_sequence<I...> indexes) noexcept
+{
+        std::variant<std::monostate, const E *...> result;
+        match_tree<E...>(err, innermost, result, indexes);
+        return result;
+}
+/// @endcond
+}
+
 }
 
 #if not defined(ERRORS_DISABLE_OSTREAM)
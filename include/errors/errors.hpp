@@ -1,25 +1,57 @@
 #pragma once
 
+#include "errors/chain_formatter.hpp"
+#include "errors/clone.hpp"
+#include "errors/cloneable.hpp"
 #include "errors/config.hpp"
 #include "errors/error.hpp"
 #include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
 #include "errors/impl/base_error.hpp"
 #include "errors/impl/code_error.hpp"
 #include "errors/impl/error_with_cause.hpp"
 #include "errors/impl/exception_error.hpp"
+#include "errors/impl/inline_message.hpp"
+#include "errors/impl/joined_error.hpp"
 #include "errors/impl/runtime_error.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/stacktrace.hpp"
 #include "errors/impl/system_error.hpp"
+#include "errors/impl/trace_error.hpp"
 #include "errors/impl/wrap_error.hpp"
+#include "errors/intern.hpp"
+#include "errors/join.hpp"
+#include "errors/json_writer.hpp"
+#include "errors/literal.hpp"
 #include "errors/make.hpp"
+#include "errors/memory_resource.hpp"
+#include "errors/metrics.hpp"
+#include "errors/report_limiter.hpp"
+#include "errors/shared_error.hpp"
 #include "errors/source_location.hpp"
+#include "errors/source_site.hpp"
+#include "errors/stacktrace.hpp"
+#include "errors/trace.hpp"
+#include "errors/type_id.hpp"
 #include "errors/utils.hpp"
 #include "errors/version.hpp"
+#include "errors/wire.hpp"
 #include "errors/wrap.hpp"
 
+// NOTE:
+// async_log writes with POSIX write(2).
+#if __has_include(<unistd.h>)
+#include "errors/async_log.hpp"
+#endif
+
 #if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
 #include "errors/json.hpp"
 #endif
 
+#if defined(ERRORS_ENABLE_FMT_SUPPORT)
+#include "errors/fmt.hpp"
+#endif
+
 // Generate main page for the reference documentation.
 
 /// @mainpage
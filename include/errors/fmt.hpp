@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+
+#include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
+#include "fmt/format.h"
+
+/// @brief
+/// Format ::errors::error_ptr with `fmt`.
+///
+/// @details
+/// The format specification selects the ::errors::format_style:
+/// `{}` or `{:c}` for ::errors::format_style::chain,
+/// `{:l}` for ::errors::format_style::located
+/// and `{:i}` for ::errors::format_style::innermost.
+/// The error chain is written directly to the output iterator,
+/// no `std::ostream` is involved.
+template <>
+struct fmt::formatter<errors::error_ptr> {
+        errors::format_style style = errors::format_style::chain;
+
+        constexpr format_parse_context::iterator
+        parse(format_parse_context &ctx)
+        {
+                auto it = ctx.begin();
+                if (it != ctx.end() &&
+                    errors::detail::parse_format_style(*it, this->style)) {
+                        ++it;
+                }
+                if (it != ctx.end() && *it != '}') {
+                        throw format_error("invalid format specification "
+                                           "for errors::error_ptr");
+                }
+                return it;
+        }
+
+        template <typename FormatContext>
+        typename FormatContext::iterator format(const errors::error_ptr &err,
+                                                FormatContext &ctx) const
+        {
+                // NOTE:
+                // Write through the formatter of string_view,
+                // which appends a whole piece to the buffer of fmt at once
+                // instead of pushing characters one by one.
+                formatter<string_view> text;
+                auto sink = [&text, &ctx](const char *data, std::size_t size) {
+                        ctx.advance_to(text.format(string_view(data, size),
+                                                   ctx));
+                };
+                errors::detail::format_styled(sink, err.get(), this->style);
+                return ctx.out();
+        }
+};
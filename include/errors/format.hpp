@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "errors/detail/bounded_sink.hpp"
+#include "errors/error_ptr.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/stacktrace.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// The output format of an error chain.
+enum class format_style {
+        /// @brief
+        /// Messages of errors joined by `": "`,
+        /// the same as the default `operator<<`.
+        chain,
+        /// @brief
+        /// One line for each error,
+        /// each starts with a newline
+        /// followed by the source location and the message,
+        /// like `[function main at main.cpp 42:9] message`.
+        /// Frames recorded by ::errors::trace are expanded,
+        /// Stack traces recorded by ::errors::sample_stacktraces
+        /// follow the line of their error,
+        /// one line for each frame like `    #0 symbol`.
+        located,
+        /// @brief
+        /// Only the message of the innermost error.
+        innermost,
+};
+
+namespace detail
+{
+
+/// @cond
+template <typename Sink>
+void put_string(Sink &sink, const char *str)
+{
+        sink(str, std::strlen(str));
+}
+
+template <typename Sink>
+void format_chain(Sink &sink, const error *err)
+{
+        // NOTE:
+        // Keep the same output as the default operator<<.
+        bool printed = false;
+        for (; err != nullptr; err = err->cause().get()) {
+                if (printed) {
+                        sink(": ", 2);
+                        printed = false;
+                }
+
+                const auto *what = err->what();
+                auto size = std::strlen(what);
+                if (size != 0) {
+                        sink(what, size);
+                        printed = true;
+                }
+        }
+}
+
+template <typename Sink>
+void format_location(Sink &sink,
+                     const std::optional<source_location> &location)
+{
+        if (!location) {
+                put_string(sink, "\n[source location not available] ");
+                return;
+        }
+
+        const auto *file = location->file_name();
+        for (const auto *p = file; *p != '\0'; ++p) {
+                if (*p == '/' || *p == '\\') {
+                        file = p + 1;
+                }
+        }
+
+        char number[16];
+        put_string(sink, "\n[function ");
+        put_string(sink, location->function_name());
+        put_string(sink, " at ");
+        put_string(sink, file);
+        sink(" ", 1);
+        auto result = std::to_chars(number, number + sizeof(number),
+                                    location->line());
+        sink(number, result.ptr - number);
+        sink(":", 1);
+        result = std::to_chars(number, number + sizeof(number),
+                               location->column());
+        sink(number, result.ptr - number);
+        sink("] ", 2);
+}
+
+template <typename Sink>
+void format_stacktrace(Sink &sink, const impl::stacktrace *stack)
+{
+        char number[16];
+        for (std::size_t i = 0; i < stack->size(); ++i) {
+                put_string(sink, "\n    #");
+                auto result =
+                        std::to_chars(number, number + sizeof(number), i);
+                sink(number, result.ptr - number);
+                sink(" ", 1);
+                put_string(sink, stack->symbol(i));
+        }
+}
+
+template <typename Sink>
+void format_located(Sink &sink, const error *err)
+{
+        for (; err != nullptr; err = err->cause().get()) {
+                const auto *trace = cast<impl::trace_error>(err);
+                if (trace == nullptr) {
+                        format_location(sink, err->location());
+                        put_string(sink, err->what());
+
+                        const auto *stack = stacktrace_of(err);
+                        if (stack != nullptr) {
+                                format_stacktrace(sink, stack);
+                        }
+                        continue;
+                }
+
+                for (std::size_t i = 0; i < trace->size(); ++i) {
+                        format_location(sink, trace->frame(i));
+                }
+        }
+}
+
+template <typename Sink>
+void format_innermost(Sink &sink, const error *err)
+{
+        const auto *innermost = err;
+        for (; err != nullptr; err = err->cause().get()) {
+                innermost = err;
+        }
+        put_string(sink, innermost->what());
+}
+
+template <typename Sink>
+void format_styled(Sink &sink, const error *err, format_style style)
+{
+        if (err == nullptr) {
+                put_string(sink, "no error");
+                return;
+        }
+
+        switch (style) {
+        case format_style::chain:
+                format_chain(sink, err);
+                return;
+        case format_style::located:
+                format_located(sink, err);
+                return;
+        case format_style::innermost:
+                format_innermost(sink, err);
+                return;
+        }
+}
+
+constexpr bool parse_format_style(char c, format_style &style) noexcept
+{
+        switch (c) {
+        case 'c':
+                style = format_style::chain;
+                return true;
+        case 'l':
+                style = format_style::located;
+                return true;
+        case 'i':
+                style = format_style::innermost;
+                return true;
+        default:
+                return false;
+        }
+}
+/// @endcond
+
+}
+
+/// @brief
+/// Get the length of the formatted error chain.
+///
+/// @details
+/// By default, the error chain is formatted
+/// the same as the default `operator<<`:
+/// messages of errors are joined by `": "`.
+/// A null error is `"no error"` in all styles.
+///
+/// @param err
+/// The error chain.
+///
+/// @param style
+/// The output format.
+///
+/// @return
+/// The exact number of bytes written by ::errors::format_to.
+[[nodiscard]]
+inline std::size_t formatted_size(const error_ptr &err,
+                                  format_style style = format_style::chain)
+        noexcept
+{
+        detail::bounded_sink sink(nullptr, 0);
+        detail::format_styled(sink, err.get(), style);
+        return sink.size();
+}
+
+/// @brief
+/// Format an error chain into a caller provided buffer.
+///
+/// @details
+/// See ::errors::formatted_size for the output.
+///
+/// Like `std::snprintf`, at most `size` bytes are written
+/// and the whole length is returned,
+/// so a return value greater than `size` means
+/// the output is truncated.
+/// Unlike `std::snprintf`, no terminating null character is written.
+///
+/// This function never allocates,
+/// except that ::errors::impl::code_error
+/// renders its message on first use.
+///
+/// @param buffer
+/// The buffer, it can be `nullptr` if `size` is `0`.
+///
+/// @param size
+/// The size of the buffer.
+///
+/// @param err
+/// The error chain.
+///
+/// @param style
+/// The output format.
+///
+/// @return
+/// The length of the whole output.
+inline std::size_t format_to(char *buffer, std::size_t size,
+                             const error_ptr &err,
+                             format_style style = format_style::chain)
+        noexcept
+{
+        detail::bounded_sink sink(buffer, size);
+        detail::format_styled(sink, err.get(), style);
+        return sink.size();
+}
+
+/// @brief
+/// Append a formatted error chain to a string.
+///
+/// @details
+/// See ::errors::formatted_size for the output.
+/// The string grows at most once.
+///
+/// @param out
+/// The string to append to.
+///
+/// @param err
+/// The error chain.
+///
+/// @param style
+/// The output format.
+///
+/// @return
+/// The number of bytes appended.
+inline std::size_t format_to(std::string &out, const error_ptr &err,
+                             format_style style = format_style::chain)
+{
+        auto size = formatted_size(err, style);
+        auto offset = out.size();
+        out.resize(offset + size);
+        format_to(out.data() + offset, size, err, style);
+        return size;
+}
+
+/// @brief
+/// Write a formatted error chain to an output iterator.
+///
+/// @details
+/// See ::errors::formatted_size for the output.
+///
+/// @param out
+/// The output iterator of `char`.
+///
+/// @param err
+/// The error chain.
+///
+/// @param style
+/// The output format.
+///
+/// @return
+/// The iterator past the last character written.
+template <typename OutputIt>
+OutputIt format_to(OutputIt out, const error_ptr &err,
+                   format_style style = format_style::chain)
+{
+        auto sink = [&out](const char *data, std::size_t size) {
+                out = std::copy(data, data + size, out);
+        };
+        detail::format_styled(sink, err.get(), style);
+        return out;
+}
+
+}
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_format)
+
+#include <format>
+
+/// @brief
+/// Format ::errors::error_ptr with `std::format`.
+///
+/// @details
+/// The format specification selects the ::errors::format_style:
+/// `{}` or `{:c}` for ::errors::format_style::chain,
+/// `{:l}` for ::errors::format_style::located
+/// and `{:i}` for ::errors::format_style::innermost.
+/// The error chain is written directly to the output iterator.
+template <>
+struct std::formatter<errors::error_ptr, char> {
+        errors::format_style style = errors::format_style::chain;
+
+        template <typename ParseContext>
+        constexpr typename ParseContext::iterator parse(ParseContext &ctx)
+        {
+                auto it = ctx.begin();
+                if (it != ctx.end() &&
+                    errors::detail::parse_format_style(*it, this->style)) {
+                        ++it;
+                }
+                if (it != ctx.end() && *it != '}') {
+                        throw std::format_error(
+                                "invalid format specification "
+                                "for errors::error_ptr");
+                }
+                return it;
+        }
+
+        template <typename FormatContext>
+        typename FormatContext::iterator format(const errors::error_ptr &err,
+                                                FormatContext &ctx) const
+        {
+                return errors::format_to(ctx.out(), err, this->style);
+        }
+};
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "errors/error.hpp"
 #include "errors/source_location.hpp"
+#include "errors/source_site.hpp"
 namespace errors
 {
 namespace impl
@@ -13,6 +14,9 @@ namespace impl
 /// @details
 /// It implements the location method
 /// for all other builtin error types to derived from.
+///
+/// With `ERRORS_COMPACT_SOURCE_LOCATION` defined,
+/// the source location is stored as an ::errors::source_site.
 class base_error : public virtual error {
     public:
         /// @brief
@@ -27,11 +31,22 @@ class base_error : public virtual error {
 
         std::optional<source_location> location() const noexcept override
         {
-                return this->loc;
+                return detail::load_location(this->loc);
+        }
+
+    protected:
+        /// @brief
+        /// Constructor copying the source location of another error.
+        ///
+        /// @param other
+        /// The error to copy.
+        base_error(const base_error &other)
+                : loc(other.loc)
+        {
         }
 
     private:
-        source_location loc;
+        detail::stored_location loc;
 };
 static_assert(std::is_abstract<base_error>());
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <string>
@@ -20,8 +21,17 @@ namespace impl
 ///
 /// @details
 /// This class is used to create an error that has a code.
+///
+/// @note
+/// `message` holds the message as given,
+/// it does not include the code,
+/// nor the text of the code added by ::errors::impl::system_error.
+/// They are only appended to the text returned by `what`.
 template <typename Code>
 class code_error : public runtime_error {
+        ERRORS_REGISTER_TYPE(code_error, runtime_error);
+        ERRORS_CLONEABLE(code_error);
+
     public:
         /// @brief
         /// Constructor with message, code and source_location.
@@ -34,22 +44,121 @@ class code_error : public runtime_error {
         ///
         /// @param location
         /// The source location.
-        code_error(const std::string &message, Code code,
-                   source_location location)
+        code_error(std::string message, Code code, source_location location)
+                : runtime_error(std::move(message), std::move(location))
+                , code(code)
+        {
+        }
+
+        /// @brief
+        /// Constructor with a string literal, code and source_location.
+        ///
+        /// @details
+        /// The message is not copied.
+        ///
+        /// @param message
+        /// The string literal.
+        ///
+        /// @param code
+        /// The code.
+        ///
+        /// @param location
+        /// The source location.
+        code_error(literal message, Code code, source_location location)
                 : runtime_error(message, std::move(location))
                 , code(code)
         {
-                this->message += " [code=" + std::to_string(code) + "]";
         }
 
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        /// The rendered message is not copied,
+        /// it is rendered again when needed.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// Ignored, this error has no cause.
+        code_error(const code_error &other, error_ptr &&cause)
+                : runtime_error(other, std::move(cause))
+                , code(other.code)
+        {
+        }
+
+        ~code_error() override
+        {
+                delete this->rendered.load(std::memory_order_acquire);
+        }
+
+        /// @brief
+        /// Get the message followed by the code.
+        ///
+        /// @details
+        /// The message is rendered
+        /// when this function is called for the first time,
+        /// so an error which is never printed
+        /// does not pay for formatting the code.
         const char *what() const noexcept override
         {
-                return this->message.c_str();
+                const auto *text =
+                        this->rendered.load(std::memory_order_acquire);
+                if (text != nullptr) {
+                        return text->c_str();
+                }
+
+                const std::string *created = nullptr;
+                try {
+                        created = new std::string(this->render());
+                } catch (...) {
+                        // NOTE:
+                        // Fall back to the bare message
+                        // if rendering fails,
+                        // and try again next time.
+                        return this->message.c_str();
+                }
+
+                // NOTE:
+                // Threads might render at the same time,
+                // the first one to publish its text wins.
+                if (this->rendered.compare_exchange_strong(
+                            text, created, std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        return created->c_str();
+                }
+                delete created;
+                return text->c_str();
         }
 
         /// @brief
         /// The error code.
         Code code;
+
+    protected:
+        /// @brief
+        /// Render the message returned by ::errors::impl::code_error::what.
+        ///
+        /// @details
+        /// It is called once for each error,
+        /// unless several threads call `what` for the first time at once.
+        [[nodiscard]]
+        virtual std::string render() const
+        {
+                std::string result(this->message.view());
+                result += " [code=";
+                result += std::to_string(this->code);
+                result += "]";
+                return result;
+        }
+
+    private:
+        // NOTE:
+        // Keep the rendered message out of line,
+        // so the error itself stays small.
+        mutable std::atomic<const std::string *> rendered{ nullptr };
 };
 
 static_assert(!std::is_abstract<code_error<unsigned int>>());
@@ -32,6 +32,20 @@ class error_with_cause : public base_error {
         {
         }
 
+        /// @brief
+        /// Constructor copying another error with a new cause.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        error_with_cause(const error_with_cause &other, error_ptr &&cause)
+                : base_error(other)
+                , cause_(std::move(cause))
+        {
+        }
+
         const error_ptr &cause() const & noexcept override
         {
                 return this->cause_;
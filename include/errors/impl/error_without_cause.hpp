@@ -17,8 +17,28 @@ namespace impl
 /// which do not have a cause to derived from.
 class error_without_cause : public base_error {
     public:
-        using base_error::base_error;
+        /// @brief
+        /// Constructor with source_location.
+        ///
+        /// @param loc
+        /// The source location.
+        error_without_cause(source_location loc)
+                : base_error(std::move(loc))
+        {
+        }
+
+    protected:
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @param other
+        /// The error to copy.
+        error_without_cause(const error_without_cause &other)
+                : base_error(other)
+        {
+        }
 
+    public:
         const error_ptr &cause() const & noexcept override
         {
                 static error_ptr null;
@@ -1,8 +1,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <new>
+#include <typeinfo>
 
+#include "errors/cloneable.hpp"
 #include "errors/impl/error_without_cause.hpp"
 
 namespace errors
@@ -16,6 +21,9 @@ namespace impl
 /// @details
 /// This class is used to create an error from an exception.
 class exception_error : public error_without_cause {
+        ERRORS_REGISTER_TYPE(exception_error);
+        ERRORS_CLONEABLE(exception_error);
+
     public:
         /// @brief
         /// Create an exception error from an exception pointer.
@@ -45,29 +53,116 @@ class exception_error : public error_without_cause {
         {
         }
 
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        /// The exception is shared with `other`.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// Ignored, this error has no cause.
+        exception_error(const exception_error &other, error_ptr &&cause)
+                : error_without_cause(other)
+                , exception_ptr(other.exception_ptr)
+        {
+                static_cast<void>(cause);
+        }
+
+        ~exception_error() override
+        {
+                delete this->cache.load(std::memory_order_acquire);
+        }
+
         /// @brief
         /// Get the exception message.
         ///
         /// @return
         /// The exception message.
         /// If the exception is not set, an empty string is returned.
+        ///
+        /// @details
+        /// The exception is rethrown only once to get the message,
+        /// the message is cached for later calls.
         const char *what() const noexcept override
         {
+                return this->load().message;
+        }
+
+        /// @brief
+        /// Get the type of the exception.
+        ///
+        /// @return
+        /// The type of the exception,
+        /// or `nullptr` if the exception is not set
+        /// or the standard library cannot report its type.
+        /// Only libstdc++ reports types of exceptions
+        /// not derived from `std::exception`.
+        ///
+        /// @details
+        /// With libstdc++, the exception is never rethrown to get the type.
+        /// Otherwise, the type is cached together with the message.
+        [[nodiscard]]
+        const std::type_info *exception_type() const noexcept
+        {
+#if defined(__GLIBCXX__)
+                if (!this->exception_ptr) {
+                        return nullptr;
+                }
+                return this->exception_ptr.__cxa_exception_type();
+#else
+                return this->load().type;
+#endif
+        }
+
+        /// @brief
+        /// The exception pointer.
+        const std::exception_ptr exception_ptr;
+
+    private:
+        struct loaded_t {
+                const char *message;
+                const std::type_info *type;
+        };
+
+        loaded_t load() const noexcept
+        {
+                const auto *cached =
+                        this->cache.load(std::memory_order_acquire);
+                if (cached != nullptr) {
+                        return *cached;
+                }
+
+                loaded_t result{ "", nullptr };
+                if (!this->exception_ptr) {
+                        return result;
+                }
                 try {
-                        if (!this->exception_ptr) {
-                                return "";
-                        }
                         std::rethrow_exception(this->exception_ptr);
                 } catch (const std::exception &e) {
-                        return e.what();
+                        result = { e.what(), &typeid(e) };
                 } catch (...) {
-                        return "Unknown exception";
+                        result.message = "Unknown exception";
                 }
+
+                // NOTE:
+                // Threads racing here rethrow the same exception,
+                // the first one to publish its result wins.
+                // Without memory the result is just not cached.
+                auto *created = new (std::nothrow) loaded_t(result);
+                if (created != nullptr &&
+                    !this->cache.compare_exchange_strong(
+                            cached, created, std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        delete created;
+                }
+                return result;
         }
 
-        /// @brief
-        /// The exception pointer.
-        std::exception_ptr exception_ptr;
+        mutable std::atomic<const loaded_t *> cache{ nullptr };
 };
 static_assert(!std::is_abstract<exception_error>());
 
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "errors/literal.hpp"
+
+namespace errors
+{
+namespace impl
+{
+
+/// @brief
+/// The message stored in builtin error types.
+///
+/// @details
+/// A message is kept in one of three ways:
+///
+/// - A short message,
+///   up to ::errors::impl::inline_message::inline_capacity characters,
+///   is copied into a buffer inside this object,
+///   so it lives in the same allocation as the error;
+/// - A message from ::errors::literal is not copied at all;
+/// - A longer message is copied into a buffer allocated by `new`.
+///
+/// It takes as much space as a `std::string`,
+/// so it does not make builtin errors larger
+/// than they were with a `std::string`.
+///
+/// Like errors, messages can be neither copied nor moved.
+class inline_message {
+    public:
+        /// @brief
+        /// The maximum length of a message stored inline.
+        ///
+        /// @details
+        /// It is chosen so that this class takes 32 bytes.
+        static constexpr std::size_t inline_capacity = 31;
+
+        /// @brief
+        /// Create an empty message.
+        inline_message() noexcept
+        {
+                this->store_inline(std::string_view());
+        }
+
+        /// @brief
+        /// Create a message by copying the text.
+        ///
+        /// @param text
+        /// The text.
+        explicit inline_message(std::string_view text)
+        {
+                if (text.size() <= inline_capacity) {
+                        this->store_inline(text);
+                        return;
+                }
+                this->store_heap(text);
+        }
+
+        /// @brief
+        /// Create a message by copying a null-terminated string.
+        ///
+        /// @param text
+        /// The null-terminated string.
+        explicit inline_message(const char *text)
+                : inline_message(std::string_view(text))
+        {
+        }
+
+        /// @brief
+        /// Create a message by copying a string.
+        ///
+        /// @param text
+        /// The string.
+        explicit inline_message(const std::string &text)
+                : inline_message(std::string_view(text))
+        {
+        }
+
+        /// @brief
+        /// Create a message referring to a string literal.
+        ///
+        /// @param text
+        /// The string literal.
+        explicit inline_message(literal text) noexcept
+        {
+                this->store_pointer(storage::literal, text.c_str(),
+                                    text.size());
+        }
+
+        /// @brief
+        /// Copy a message.
+        ///
+        /// @details
+        /// A message from ::errors::literal is still not copied.
+        ///
+        /// @param other
+        /// The message to copy.
+        [[nodiscard]]
+        static inline_message copy(const inline_message &other)
+        {
+                if (other.kind() == storage::literal) {
+                        return inline_message(other.pointer(), other.size());
+                }
+                return inline_message(other.view());
+        }
+
+        ~inline_message()
+        {
+                if (this->kind() == storage::heap) {
+                        delete[] this->pointer();
+                }
+        }
+
+        inline_message(const inline_message &) = delete;
+        inline_message(inline_message &&) = delete;
+        inline_message &operator=(const inline_message &) = delete;
+        inline_message &operator=(inline_message &&) = delete;
+
+        /// @brief
+        /// Get the null-terminated text.
+        [[nodiscard]]
+        const char *c_str() const noexcept
+        {
+                if (this->kind() == storage::buffer) {
+                        return this->buffer;
+                }
+                return this->pointer();
+        }
+
+        /// @brief
+        /// Get the length of the text.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                if (this->kind() == storage::buffer) {
+                        return inline_capacity -
+                               static_cast<std::size_t>(this->tag());
+                }
+                std::size_t length = 0;
+                std::memcpy(&length, this->buffer + sizeof(const char *),
+                            sizeof(length));
+                return length;
+        }
+
+        /// @brief
+        /// Check if the message is empty.
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+                return this->size() == 0;
+        }
+
+        /// @brief
+        /// Get the text.
+        [[nodiscard]]
+        std::string_view view() const noexcept
+        {
+                return std::string_view(this->c_str(), this->size());
+        }
+
+        operator std::string_view() const noexcept
+        {
+                return this->view();
+        }
+
+    private:
+        // NOTE:
+        // The last byte of the buffer tells how the message is stored.
+        // For a message stored inline,
+        // it is the number of unused characters,
+        // so it is also the terminating null character of a full buffer.
+        // Otherwise it is one of the values below,
+        // and the buffer starts with a pointer and a length.
+        enum class storage : unsigned char {
+                buffer,
+                literal = inline_capacity + 1,
+                heap,
+        };
+
+        inline_message(const char *text, std::size_t length) noexcept
+        {
+                this->store_pointer(storage::literal, text, length);
+        }
+
+        [[nodiscard]]
+        unsigned char tag() const noexcept
+        {
+                return static_cast<unsigned char>(
+                        this->buffer[inline_capacity]);
+        }
+
+        [[nodiscard]]
+        storage kind() const noexcept
+        {
+                if (this->tag() <= inline_capacity) {
+                        return storage::buffer;
+                }
+                return static_cast<storage>(this->tag());
+        }
+
+        [[nodiscard]]
+        const char *pointer() const noexcept
+        {
+                const char *text = nullptr;
+                std::memcpy(&text, this->buffer, sizeof(text));
+                return text;
+        }
+
+        void store_inline(std::string_view text) noexcept
+        {
+                if (!text.empty()) {
+                        std::memcpy(this->buffer, text.data(), text.size());
+                }
+                this->buffer[text.size()] = '\0';
+                this->buffer[inline_capacity] =
+                        static_cast<char>(inline_capacity - text.size());
+        }
+
+        void store_pointer(storage kind, const char *text,
+                           std::size_t length) noexcept
+        {
+                std::memcpy(this->buffer, &text, sizeof(text));
+                std::memcpy(this->buffer + sizeof(text), &length,
+                            sizeof(length));
+                this->buffer[inline_capacity] = static_cast<char>(kind);
+        }
+
+        void store_heap(std::string_view text)
+        {
+                auto *copied = new char[text.size() + 1];
+                std::memcpy(copied, text.data(), text.size());
+                copied[text.size()] = '\0';
+                this->store_pointer(storage::heap, copied, text.size());
+        }
+
+        alignas(const char *) char buffer[inline_capacity + 1];
+};
+static_assert(sizeof(inline_message) == 32);
+
+}
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "errors/clone.hpp"
+#include "errors/cloneable.hpp"
+#include "errors/impl/error_without_cause.hpp"
+#include "errors/impl/inline_message.hpp"
+#include "errors/literal.hpp"
+
+namespace errors
+{
+namespace impl
+{
+
+/// @brief
+/// A compact record of a failed item in a batch.
+///
+/// @details
+/// It is used instead of a whole error for each item,
+/// when the code and a static message are enough.
+struct batch_entry {
+        /// @brief
+        /// The index of the item in the batch.
+        std::uint32_t index;
+        /// @brief
+        /// The error code.
+        int code;
+        /// @brief
+        /// The message, which is never copied.
+        literal message;
+};
+static_assert(sizeof(batch_entry) <= 24);
+
+/// @brief
+/// An error which joins many errors.
+///
+/// @details
+/// It has no cause returned by ::errors::error::cause,
+/// instead it holds many causes next to each other,
+/// and many ::errors::impl::batch_entry for items
+/// which do not need a whole error.
+///
+/// ::errors::error_ptr::is, ::errors::error_ptr::as
+/// and ::errors::error_ptr::match search the causes depth first,
+/// in the order they were added.
+/// Formatting and serializing only print `what`,
+/// which is the message followed by the number of errors.
+///
+/// @see ::errors::join
+class joined_error final : public error_without_cause {
+        ERRORS_CLONEABLE(joined_error);
+
+    public:
+        // NOTE:
+        // Registered like ::ERRORS_REGISTER_TYPE does,
+        // and the causes are handed out to the chain walkers as well.
+        // The type is final, so no derived type looks for its bases.
+        using errors_registered_type = joined_error;
+
+        [[nodiscard]]
+        const void *cast(type_id id) const noexcept override
+        {
+                if (id == type_id_of<detail::joined_causes_tag>()) {
+                        return &this->causes_;
+                }
+                return detail::cast_registered<joined_error>(this, id);
+        }
+
+        /// @brief
+        /// Constructor with message, causes, entries and source_location.
+        ///
+        /// @param msg
+        /// The message.
+        ///
+        /// @param causes
+        /// The causes, none of which is `nullptr`.
+        ///
+        /// @param entries
+        /// The entries.
+        ///
+        /// @param loc
+        /// The source location.
+        joined_error(std::string msg, std::vector<error_ptr> causes,
+                     std::vector<batch_entry> entries, source_location loc)
+                : error_without_cause(std::move(loc))
+                , message(std::move(msg))
+                , causes_(std::move(causes))
+                , entries_(std::move(entries))
+                , rendered(render(this->message.view(), this->size()))
+        {
+        }
+
+        /// @brief
+        /// Constructor with a string literal, causes, entries
+        /// and source_location.
+        ///
+        /// @details
+        /// The message is not copied.
+        ///
+        /// @param msg
+        /// The string literal.
+        ///
+        /// @param causes
+        /// The causes, none of which is `nullptr`.
+        ///
+        /// @param entries
+        /// The entries.
+        ///
+        /// @param loc
+        /// The source location.
+        joined_error(literal msg, std::vector<error_ptr> causes,
+                     std::vector<batch_entry> entries, source_location loc)
+                : error_without_cause(std::move(loc))
+                , message(msg)
+                , causes_(std::move(causes))
+                , entries_(std::move(entries))
+                , rendered(render(this->message.view(), this->size()))
+        {
+        }
+
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        /// Each cause is copied by ::errors::clone.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// Ignored, this error has no cause.
+        joined_error(const joined_error &other, error_ptr &&cause)
+                : error_without_cause(other)
+                , message(inline_message::copy(other.message))
+                , entries_(other.entries_)
+                , rendered(inline_message::copy(other.rendered))
+        {
+                static_cast<void>(cause);
+                this->causes_.reserve(other.causes_.size());
+                for (const auto &item : other.causes_) {
+                        this->causes_.push_back(::errors::clone(item));
+                }
+        }
+
+        /// @brief
+        /// Get the message followed by the number of errors.
+        ///
+        /// @details
+        /// The number of errors never changes,
+        /// so the text is rendered once when the error is created.
+        const char *what() const noexcept override
+        {
+                return this->rendered.c_str();
+        }
+
+        /// @brief
+        /// Get the causes.
+        [[nodiscard]]
+        const std::vector<error_ptr> &causes() const noexcept
+        {
+                return this->causes_;
+        }
+
+        /// @brief
+        /// Get the entries.
+        [[nodiscard]]
+        const std::vector<batch_entry> &entries() const noexcept
+        {
+                return this->entries_;
+        }
+
+        /// @brief
+        /// Get the number of causes and entries.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->causes_.size() + this->entries_.size();
+        }
+
+        /// @brief
+        /// The error message.
+        inline_message message;
+
+    private:
+        [[nodiscard]]
+        static inline_message render(std::string_view message,
+                                     std::size_t count)
+        {
+                // NOTE:
+                // Large enough for " [errors=", any std::size_t and "]".
+                char suffix[32] = " [errors=";
+                auto *begin = message.empty() ? suffix + 1 : suffix;
+                auto *end = std::to_chars(suffix + std::strlen(suffix),
+                                          suffix + sizeof(suffix) - 1, count)
+                                    .ptr;
+                *end++ = ']';
+                auto length = static_cast<std::size_t>(end - begin);
+                auto size = message.size() + length;
+
+                // NOTE:
+                // Short texts are put together on the stack,
+                // and copied into the inline buffer without allocating.
+                if (size <= inline_message::inline_capacity) {
+                        char buffer[inline_message::inline_capacity];
+                        std::memcpy(buffer, message.data(), message.size());
+                        std::memcpy(buffer + message.size(), begin, length);
+                        return inline_message(std::string_view(buffer, size));
+                }
+
+                std::string result;
+                result.reserve(size);
+                result.append(message);
+                result.append(begin, length);
+                return inline_message(std::move(result));
+        }
+
+        std::vector<error_ptr> causes_;
+        std::vector<batch_entry> entries_;
+        inline_message rendered;
+};
+static_assert(!std::is_abstract<joined_error>());
+
+}
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
+#include "errors/cloneable.hpp"
 #include "errors/impl/error_without_cause.hpp"
+#include "errors/impl/inline_message.hpp"
+#include "errors/literal.hpp"
 
 namespace errors
 {
@@ -16,6 +20,9 @@ namespace impl
 /// @details
 /// This class is used to create an error that has a message.
 class runtime_error : public error_without_cause {
+        ERRORS_REGISTER_TYPE(runtime_error);
+        ERRORS_CLONEABLE(runtime_error);
+
     public:
         /// @brief
         /// Constructor with message and source_location.
@@ -31,6 +38,64 @@ class runtime_error : public error_without_cause {
         {
         }
 
+        /// @brief
+        /// Constructor with message and source_location.
+        ///
+        /// @details
+        /// The message is copied without creating a `std::string`.
+        ///
+        /// @param msg
+        /// The message.
+        ///
+        /// @param loc
+        /// The source location.
+        runtime_error(std::string_view msg, source_location loc)
+                : error_without_cause(std::move(loc))
+                , message(msg)
+        {
+        }
+
+        /// @copydoc runtime_error(std::string_view, source_location)
+        runtime_error(const char *msg, source_location loc)
+                : runtime_error(std::string_view(msg), std::move(loc))
+        {
+        }
+
+        /// @brief
+        /// Constructor with a string literal and source_location.
+        ///
+        /// @details
+        /// The message is not copied.
+        ///
+        /// @param msg
+        /// The string literal.
+        ///
+        /// @param loc
+        /// The source location.
+        runtime_error(literal msg, source_location loc)
+                : error_without_cause(std::move(loc))
+                , message(msg)
+        {
+        }
+
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// Ignored, this error has no cause.
+        runtime_error(const runtime_error &other, error_ptr &&cause)
+                : error_without_cause(other)
+                , message(inline_message::copy(other.message))
+        {
+                static_cast<void>(cause);
+        }
+
         const char *what() const noexcept override
         {
                 return this->message.c_str();
@@ -38,7 +103,8 @@ class runtime_error : public error_without_cause {
 
         /// @brief
         /// The error message.
-        std::string message;
+        inline_message message;
+
 };
 static_assert(!std::is_abstract<runtime_error>());
 
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "errors/error_ptr.hpp"
+#include "errors/impl/stacktrace.hpp"
+#include "errors/memory_resource.hpp"
+#include "errors/type_id.hpp"
+
+namespace errors
+{
+namespace detail
+{
+/// @cond
+struct stacktrace_tag;
+struct sampled_type_tag;
+
+template <typename E, typename = void>
+struct is_cloneable : std::false_type {};
+
+template <typename E>
+struct is_cloneable<E, std::void_t<typename E::errors_cloneable_type>>
+        : std::is_same<typename E::errors_cloneable_type, E> {};
+/// @endcond
+}
+
+namespace impl
+{
+
+/// @brief
+/// An error of type `E` with the stack trace where it was created.
+///
+/// @details
+/// ::errors::make::with creates it instead of `E`
+/// when the error is sampled by ::errors::sample_stacktraces.
+/// It is an `E` and takes the place of `E` in the chain,
+/// so `what`, `location`, `dynamic_cast`
+/// and ::errors::error_ptr::as work as if it was not sampled.
+///
+/// It is cloneable if `E` is, and the copy keeps the stack trace.
+///
+/// @tparam E
+/// The error type passed to ::errors::make.
+template <typename E>
+class sampled_error final : public E, public stacktrace {
+    public:
+        /// @brief
+        /// Constructor with the return addresses
+        /// and the arguments of the constructor of `E`.
+        ///
+        /// @param frames
+        /// The return addresses, from the innermost frame.
+        ///
+        /// @param size
+        /// The number of addresses.
+        ///
+        /// @param args
+        /// The arguments passed to the constructor of `E`.
+        template <typename... Args>
+        sampled_error(void *const *frames, std::size_t size, Args &&...args)
+                : E(std::forward<Args>(args)...)
+                , stacktrace(frames, size)
+        {
+        }
+
+        /// @brief
+        /// Constructor copying another error with a new cause.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        sampled_error(const sampled_error &other, error_ptr &&cause)
+                : E(other, std::move(cause))
+                , stacktrace(other)
+        {
+        }
+
+        [[nodiscard]]
+        const void *cast(type_id id) const noexcept override
+        {
+                if (id == type_id_of<detail::stacktrace_tag>()) {
+                        return static_cast<const stacktrace *>(this);
+                }
+                if (id == type_id_of<detail::sampled_type_tag>()) {
+                        return &typeid(E);
+                }
+                return this->E::cast(id);
+        }
+
+        [[nodiscard]]
+        std::size_t clone_size() const noexcept override
+        {
+                if constexpr (detail::is_cloneable<E>::value) {
+                        return detail::allocation_size<sampled_error>();
+                } else {
+                        return 0;
+                }
+        }
+
+        [[nodiscard]]
+        error_ptr clone(std::pmr::memory_resource *resource,
+                        error_ptr &&cause) const override
+        {
+                if constexpr (detail::is_cloneable<E>::value) {
+                        return detail::allocate<sampled_error>(
+                                resource, *this, std::move(cause));
+                } else {
+                        static_cast<void>(resource);
+                        static_cast<void>(cause);
+                        return nullptr;
+                }
+        }
+};
+
+}
+
+namespace detail
+{
+/// @cond
+inline const impl::stacktrace *stacktrace_of(const error *err) noexcept
+{
+        return static_cast<const impl::stacktrace *>(
+                err->cast(type_id_of<stacktrace_tag>()));
+}
+
+inline const std::type_info &sampled_type_of(const error *err) noexcept
+{
+        const auto *type = static_cast<const std::type_info *>(
+                err->cast(type_id_of<sampled_type_tag>()));
+        return type == nullptr ? typeid(*err) : *type;
+}
+/// @endcond
+}
+
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ERRORS_HAS_EXECINFO 1
+#endif
+
+namespace errors
+{
+namespace impl
+{
+
+/// @brief
+/// The raw return addresses of the stack
+/// where an error was created.
+///
+/// @details
+/// Recording it only copies the addresses into an inline buffer,
+/// they are turned into symbols
+/// when `symbol` is called for the first time,
+/// which is when the error is formatted with
+/// ::errors::format_style::located or serialized to JSON.
+///
+/// It is not an error itself,
+/// but a part of an ::errors::impl::sampled_error.
+///
+/// @see ::errors::sample_stacktraces
+class stacktrace {
+    public:
+        /// @brief
+        /// The maximum number of frames recorded.
+        static constexpr std::size_t capacity = 32;
+
+        /// @brief
+        /// Constructor with the return addresses.
+        ///
+        /// @param frames
+        /// The return addresses, from the innermost frame.
+        ///
+        /// @param size
+        /// The number of addresses,
+        /// only the first ::errors::impl::stacktrace::capacity are kept.
+        stacktrace(void *const *frames, std::size_t size) noexcept
+                : count(std::min(size, capacity))
+        {
+                std::copy(frames, frames + this->count, this->frames.begin());
+        }
+
+        /// @brief
+        /// Copy constructor.
+        ///
+        /// @details
+        /// The symbols are not copied,
+        /// they are looked up again when needed.
+        stacktrace(const stacktrace &other) noexcept
+                : frames(other.frames)
+                , count(other.count)
+        {
+        }
+
+        stacktrace &operator=(const stacktrace &) = delete;
+
+        ~stacktrace()
+        {
+                delete this->symbols.load(std::memory_order_acquire);
+        }
+
+        /// @brief
+        /// Get the number of frames recorded.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->count;
+        }
+
+        /// @brief
+        /// Get the return address of a frame.
+        ///
+        /// @param index
+        /// The index of the frame,
+        /// `0` is the innermost one.
+        [[nodiscard]]
+        void *address(std::size_t index) const noexcept
+        {
+                return this->frames[index];
+        }
+
+        /// @brief
+        /// Get the symbol of a frame.
+        ///
+        /// @details
+        /// All frames are symbolized once,
+        /// when this function is called for the first time.
+        /// Without `<execinfo.h>`, the address in hexadecimal is returned.
+        ///
+        /// @param index
+        /// The index of the frame,
+        /// `0` is the innermost one.
+        ///
+        /// @return
+        /// The symbol,
+        /// or an empty string if symbolization failed.
+        [[nodiscard]]
+        const char *symbol(std::size_t index) const noexcept
+        {
+                const auto *names = this->load();
+                if (names == nullptr || index >= names->size()) {
+                        return "";
+                }
+                return (*names)[index].c_str();
+        }
+
+    private:
+        using symbols_t = std::vector<std::string>;
+
+        [[nodiscard]]
+        const symbols_t *load() const noexcept
+        {
+                const auto *names =
+                        this->symbols.load(std::memory_order_acquire);
+                if (names != nullptr) {
+                        return names;
+                }
+
+                symbols_t *symbolized = nullptr;
+                try {
+                        symbolized = new symbols_t(this->symbolize());
+                } catch (...) {
+                        // NOTE:
+                        // Leave the symbols empty,
+                        // and try again next time.
+                        return nullptr;
+                }
+
+                // NOTE:
+                // Threads might symbolize at the same time,
+                // the first one to publish its symbols wins.
+                if (this->symbols.compare_exchange_strong(
+                            names, symbolized, std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        return symbolized;
+                }
+                delete symbolized;
+                return names;
+        }
+
+        [[nodiscard]]
+        symbols_t symbolize() const
+        {
+                symbols_t result;
+                result.reserve(this->count);
+#if defined(ERRORS_HAS_EXECINFO)
+                std::unique_ptr<char *, decltype(&std::free)> names(
+                        backtrace_symbols(this->frames.data(),
+                                          static_cast<int>(this->count)),
+                        &std::free);
+                if (names != nullptr) {
+                        for (std::size_t i = 0; i < this->count; ++i) {
+                                result.emplace_back(names.get()[i]);
+                        }
+                        return result;
+                }
+#endif
+                for (std::size_t i = 0; i < this->count; ++i) {
+                        char buffer[2 + sizeof(void *) * 2];
+                        buffer[0] = '0';
+                        buffer[1] = 'x';
+                        auto address = reinterpret_cast<std::uintptr_t>(
+                                this->frames[i]);
+                        auto end = std::to_chars(buffer + 2,
+                                                 buffer + sizeof(buffer),
+                                                 address, 16)
+                                           .ptr;
+                        result.emplace_back(buffer, end);
+                }
+                return result;
+        }
+
+        std::array<void *, capacity> frames;
+        std::size_t count;
+        mutable std::atomic<const symbols_t *> symbols{ nullptr };
+};
+
+}
+}
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <cassert>
-#include <cstring>
+#include <cerrno>
 #include <string>
 
+#include "errors/detail/errno_message.hpp"
 #include "errors/impl/code_error.hpp"
 
 namespace errors
@@ -13,7 +14,15 @@ namespace impl
 
 /// @brief
 /// An error that has a system error code.
+///
+/// @details
+/// `what` returns the message, the text of the code and the code.
+/// `message` only holds the message as given,
+/// see ::errors::impl::code_error.
 class system_error : public code_error<int> {
+        ERRORS_REGISTER_TYPE(system_error, code_error<int>);
+        ERRORS_CLONEABLE(system_error);
+
     public:
         /// @brief
         /// Create a system error from a message and a code.
@@ -27,10 +36,8 @@ class system_error : public code_error<int> {
         ///
         /// @param location
         /// The source location.
-        system_error(const std::string &message, int code,
-                     source_location location)
-                : code_error(message + ": " + strerror(code), code,
-                             std::move(location))
+        system_error(std::string message, int code, source_location location)
+                : code_error(std::move(message), code, std::move(location))
         {
         }
 
@@ -44,7 +51,8 @@ class system_error : public code_error<int> {
         /// @param location
         /// The source location.
         system_error(int code, source_location location)
-                : code_error(strerror(code), code, std::move(location))
+                : code_error(literal(detail::literal_tag(), no_message), code,
+                             std::move(location))
         {
         }
 
@@ -57,9 +65,8 @@ class system_error : public code_error<int> {
         ///
         /// @param location
         /// The source location.
-        system_error(const std::string &message, source_location location)
-                : code_error(message + ": " + strerror(errno), errno,
-                             std::move(location))
+        system_error(std::string message, source_location location)
+                : system_error(std::move(message), errno, std::move(location))
         {
         }
 
@@ -70,11 +77,60 @@ class system_error : public code_error<int> {
         /// @param location
         /// The source location.
         system_error(source_location location)
-                : code_error(strerror(errno), errno, std::move(location))
+                : system_error(errno, std::move(location))
         {
         }
+
+        /// @brief
+        /// Constructor copying another error.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// Ignored, this error has no cause.
+        system_error(const system_error &other, error_ptr &&cause)
+                : code_error(other, std::move(cause))
+        {
+        }
+
+    protected:
+        /// @brief
+        /// Render the message of the code,
+        /// the extra message and the code.
+        ///
+        /// @details
+        /// The message of the code is looked up
+        /// in ::errors::detail::errno_messages,
+        /// which is safe to use from many threads at once.
+        [[nodiscard]]
+        std::string render() const override
+        {
+                std::string result;
+                // NOTE:
+                // Only errors created without a message omit the separator,
+                // an empty message is still followed by it.
+                if (this->message.c_str() != no_message) {
+                        result += this->message.view();
+                        result += ": ";
+                }
+                detail::append_errno_message(result, this->code);
+                result += " [code=";
+                result += std::to_string(this->code);
+                result += "]";
+                return result;
+        }
+
+    private:
+        // NOTE:
+        // Copies of a literal keep pointing to it,
+        // so its address marks errors created without a message.
+        static constexpr char no_message[] = "";
 };
 
-static_assert(!std::is_abstract<code_error<unsigned int>>());
+static_assert(!std::is_abstract<system_error>());
 }
 }
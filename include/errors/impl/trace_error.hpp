@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "errors/cloneable.hpp"
+#include "errors/impl/error_with_cause.hpp"
+#include "errors/source_site.hpp"
+
+namespace errors
+{
+namespace impl
+{
+
+/// @brief
+/// An error which records the source locations of several frames
+/// the cause has been passed through.
+///
+/// @details
+/// It is the compact form of a chain of location-only
+/// ::errors::impl::wrap_error.
+/// Up to ::errors::impl::trace_error::capacity frames
+/// are stored inline in one error.
+///
+/// `location` returns the outermost frame,
+/// use `frame` to get the others.
+/// `what` always returns an empty string.
+///
+/// @see ::errors::trace
+class trace_error final : public error_with_cause {
+        ERRORS_REGISTER_TYPE(trace_error);
+        ERRORS_CLONEABLE(trace_error);
+
+    public:
+        /// @brief
+        /// The maximum number of frames stored in one error.
+        static constexpr std::size_t capacity = 8;
+
+        /// @brief
+        /// Constructor with cause and the source location
+        /// of the innermost frame.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        ///
+        /// @param loc
+        /// The source location.
+        trace_error(error_ptr &&cause, source_location loc)
+                : error_with_cause(std::move(cause), std::move(loc))
+        {
+        }
+
+        /// @brief
+        /// Constructor copying another error with a new cause.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        trace_error(const trace_error &other, error_ptr &&cause)
+                : error_with_cause(other, std::move(cause))
+                , outer(other.outer)
+                , count(other.count)
+        {
+        }
+
+        const char *what() const noexcept override
+        {
+                return "";
+        }
+
+        std::optional<source_location> location() const noexcept override
+        {
+                return this->frame(0);
+        }
+
+        /// @brief
+        /// Record an outer frame.
+        ///
+        /// @param loc
+        /// The source location of the frame.
+        ///
+        /// @return
+        /// `false` if this error is full.
+        bool push(source_location loc) noexcept
+        {
+                if (this->count == this->outer.size()) {
+                        return false;
+                }
+                this->outer[this->count] = detail::stored_location(loc);
+                ++this->count;
+                return true;
+        }
+
+        /// @brief
+        /// Get the number of frames recorded.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->count + 1;
+        }
+
+        /// @brief
+        /// Get the source location of a frame.
+        ///
+        /// @param index
+        /// The index of the frame,
+        /// `0` is the outermost one,
+        /// `size() - 1` is the innermost one.
+        [[nodiscard]]
+        source_location frame(std::size_t index) const noexcept
+        {
+                assert(index < this->size());
+                if (index == this->count) {
+                        return error_with_cause::location().value_or(
+                                source_location());
+                }
+                return detail::load_location(
+                               this->outer[this->count - 1 - index])
+                        .value_or(source_location());
+        }
+
+    private:
+        std::array<detail::stored_location, capacity - 1> outer;
+        std::size_t count = 0;
+};
+static_assert(!std::is_abstract<trace_error>());
+
+}
+}
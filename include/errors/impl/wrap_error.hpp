@@ -1,8 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
+#include "errors/cloneable.hpp"
 #include "errors/impl/error_with_cause.hpp"
+#include "errors/impl/inline_message.hpp"
+#include "errors/literal.hpp"
 
 namespace errors
 {
@@ -21,6 +25,9 @@ namespace impl
 ///
 /// @see ::errors::wrap
 class wrap_error : public error_with_cause {
+        ERRORS_REGISTER_TYPE(wrap_error);
+        ERRORS_CLONEABLE(wrap_error);
+
     public:
         /// @brief
         /// Constructor with cause and source_location.
@@ -52,13 +59,78 @@ class wrap_error : public error_with_cause {
         {
         }
 
+        /// @brief
+        /// Constructor with message, cause and source_location.
+        ///
+        /// @details
+        /// The message is copied without creating a `std::string`.
+        ///
+        /// @param msg
+        /// The error message.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        ///
+        /// @param loc
+        /// The source location.
+        wrap_error(std::string_view msg, error_ptr &&cause,
+                   source_location loc)
+                : error_with_cause(std::move(cause), std::move(loc))
+                , message(msg)
+        {
+        }
+
+        /// @copydoc wrap_error(std::string_view, error_ptr &&, source_location)
+        wrap_error(const char *msg, error_ptr &&cause, source_location loc)
+                : wrap_error(std::string_view(msg), std::move(cause),
+                             std::move(loc))
+        {
+        }
+
+        /// @brief
+        /// Constructor with a string literal, cause and source_location.
+        ///
+        /// @details
+        /// The message is not copied.
+        ///
+        /// @param msg
+        /// The string literal.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        ///
+        /// @param loc
+        /// The source location.
+        wrap_error(literal msg, error_ptr &&cause, source_location loc)
+                : error_with_cause(std::move(cause), std::move(loc))
+                , message(msg)
+        {
+        }
+
+        /// @brief
+        /// Constructor copying another error with a new cause.
+        ///
+        /// @details
+        /// See ::ERRORS_CLONEABLE.
+        ///
+        /// @param other
+        /// The error to copy.
+        ///
+        /// @param cause
+        /// The cause of the error.
+        wrap_error(const wrap_error &other, error_ptr &&cause)
+                : error_with_cause(other, std::move(cause))
+                , message(inline_message::copy(other.message))
+        {
+        }
+
         const char *what() const noexcept override
         {
-                return this->message.has_value() ? this->message->c_str() : "";
+                return this->message.c_str();
         }
 
     private:
-        std::optional<std::string> message;
+        inline_message message;
 };
 static_assert(!std::is_abstract<wrap_error>());
 
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+#include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
+#include "errors/impl/code_error.hpp"
+#include "errors/impl/joined_error.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+namespace detail
+{
+
+/// @cond
+struct interned_entry {
+        explicit interned_entry(error_ptr &&err) noexcept
+                : err(std::move(err))
+        {
+        }
+
+        error_ptr err;
+        std::atomic<std::size_t> count{ 1 };
+        std::once_flag formatted;
+        std::string text;
+};
+
+inline std::size_t hash_combine(std::size_t seed, std::size_t value) noexcept
+{
+        return seed ^ (value + 0x9e3779b9U + (seed << 6) + (seed >> 2));
+}
+
+inline std::size_t hash_string(std::size_t seed, const char *str) noexcept
+{
+        return hash_combine(
+                seed, std::hash<std::string_view>()(std::string_view(str)));
+}
+
+inline std::size_t
+hash_location(std::size_t seed,
+              const std::optional<source_location> &location) noexcept
+{
+        if (!location) {
+                return hash_combine(seed, 0);
+        }
+        seed = hash_combine(seed, location->line());
+        seed = hash_combine(seed, location->column());
+        seed = hash_string(seed, location->file_name());
+        return hash_string(seed, location->function_name());
+}
+
+inline bool equal_location(const std::optional<source_location> &lhs,
+                           const std::optional<source_location> &rhs) noexcept
+{
+        if (!lhs || !rhs) {
+                return !lhs && !rhs;
+        }
+        return lhs->line() == rhs->line() && lhs->column() == rhs->column() &&
+               std::strcmp(lhs->file_name(), rhs->file_name()) == 0 &&
+               std::strcmp(lhs->function_name(), rhs->function_name()) == 0;
+}
+
+inline std::size_t hash_chain(const error *err);
+inline bool equal_chain(const error *lhs, const error *rhs);
+
+inline std::size_t hash_joined(std::size_t seed,
+                               const impl::joined_error &joined)
+{
+        seed = hash_combine(seed, std::hash<std::string_view>()(
+                                          joined.message.view()));
+        for (const auto &cause : joined.causes()) {
+                seed = hash_combine(seed, hash_chain(cause.get()));
+        }
+        for (const auto &entry : joined.entries()) {
+                seed = hash_combine(seed, entry.index);
+                seed = hash_combine(seed, std::hash<int>()(entry.code));
+                seed = hash_combine(seed, std::hash<std::string_view>()(
+                                                  entry.message.view()));
+        }
+        return seed;
+}
+
+inline bool equal_joined(const impl::joined_error &lhs,
+                         const impl::joined_error &rhs)
+{
+        if (lhs.message.view() != rhs.message.view() ||
+            lhs.causes().size() != rhs.causes().size() ||
+            lhs.entries().size() != rhs.entries().size()) {
+                return false;
+        }
+        for (std::size_t i = 0; i < lhs.causes().size(); ++i) {
+                if (!equal_chain(lhs.causes()[i].get(),
+                                 rhs.causes()[i].get())) {
+                        return false;
+                }
+        }
+        for (std::size_t i = 0; i < lhs.entries().size(); ++i) {
+                const auto &entry = lhs.entries()[i];
+                const auto &other = rhs.entries()[i];
+                if (entry.index != other.index || entry.code != other.code ||
+                    entry.message.view() != other.message.view()) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+inline std::size_t hash_node(std::size_t seed, const error *err)
+{
+        seed = hash_combine(seed, typeid(*err).hash_code());
+
+        const auto *trace = cast<impl::trace_error>(err);
+        if (trace != nullptr) {
+                for (std::size_t i = 0; i < trace->size(); ++i) {
+                        seed = hash_location(seed, trace->frame(i));
+                }
+                return seed;
+        }
+
+        seed = hash_location(seed, err->location());
+
+        // NOTE:
+        // The message of a joined error only counts its causes,
+        // so hash the causes themselves.
+        const auto *joined = cast<impl::joined_error>(err);
+        if (joined != nullptr) {
+                return hash_joined(seed, *joined);
+        }
+
+        // NOTE:
+        // Hash the code instead of the rendered message,
+        // so a duplicate is dropped before it pays for rendering.
+        const auto *coded = cast<impl::code_error<int>>(err);
+        if (coded != nullptr) {
+                seed = hash_combine(seed, std::hash<int>()(coded->code));
+                return hash_combine(seed, std::hash<std::string_view>()(
+                                                  coded->message.view()));
+        }
+        return hash_string(seed, err->what());
+}
+
+inline bool equal_node(const error *lhs, const error *rhs)
+{
+        if (typeid(*lhs) != typeid(*rhs)) {
+                return false;
+        }
+
+        const auto *trace = cast<impl::trace_error>(lhs);
+        if (trace != nullptr) {
+                const auto *other = cast<impl::trace_error>(rhs);
+                if (trace->size() != other->size()) {
+                        return false;
+                }
+                for (std::size_t i = 0; i < trace->size(); ++i) {
+                        if (!equal_location(trace->frame(i),
+                                            other->frame(i))) {
+                                return false;
+                        }
+                }
+                return true;
+        }
+
+        if (!equal_location(lhs->location(), rhs->location())) {
+                return false;
+        }
+
+        const auto *joined = cast<impl::joined_error>(lhs);
+        if (joined != nullptr) {
+                return equal_joined(*joined,
+                                    *cast<impl::joined_error>(rhs));
+        }
+
+        const auto *coded = cast<impl::code_error<int>>(lhs);
+        if (coded != nullptr) {
+                const auto *other = cast<impl::code_error<int>>(rhs);
+                return coded->code == other->code &&
+                       coded->message.view() == other->message.view();
+        }
+        return std::strcmp(lhs->what(), rhs->what()) == 0;
+}
+
+inline std::size_t hash_chain(const error *err)
+{
+        std::size_t seed = 0;
+        for (; err != nullptr; err = err->cause().get()) {
+                seed = hash_node(seed, err);
+        }
+        return seed;
+}
+
+inline bool equal_chain(const error *lhs, const error *rhs)
+{
+        while (lhs != nullptr && rhs != nullptr) {
+                if (!equal_node(lhs, rhs)) {
+                        return false;
+                }
+                lhs = lhs->cause().get();
+                rhs = rhs->cause().get();
+        }
+        return lhs == rhs;
+}
+/// @endcond
+
+}
+
+/// @brief
+/// A counted reference to an immutable error chain
+/// shared by ::errors::intern_table.
+class interned_error {
+    public:
+        /// @brief
+        /// Create a reference to no error.
+        interned_error() noexcept = default;
+
+        /// @brief
+        /// Check if this refers to an error.
+        explicit operator bool() const noexcept
+        {
+                return this->entry != nullptr;
+        }
+
+        /// @brief
+        /// Get the outermost error of the chain.
+        ///
+        /// @return
+        /// The error, or `nullptr`.
+        [[nodiscard]]
+        const error *get() const noexcept
+        {
+                return this->entry == nullptr ? nullptr
+                                              : this->entry->err.get();
+        }
+
+        const error *operator->() const noexcept
+        {
+                return this->get();
+        }
+
+        const error &operator*() const noexcept
+        {
+                return *this->get();
+        }
+
+        /// @brief
+        /// Get the shared error chain.
+        ///
+        /// @details
+        /// Use it with ::errors::format_to, ::errors::write_json
+        /// and so on.
+        [[nodiscard]]
+        const error_ptr &chain() const noexcept
+        {
+                static const error_ptr none;
+                return this->entry == nullptr ? none : this->entry->err;
+        }
+
+        /// @brief
+        /// Get the number of times this chain has been interned.
+        [[nodiscard]]
+        std::size_t count() const noexcept
+        {
+                return this->entry == nullptr
+                               ? 0
+                               : this->entry->count.load(
+                                         std::memory_order_relaxed);
+        }
+
+        /// @brief
+        /// Get the formatted error chain.
+        ///
+        /// @details
+        /// The chain is formatted by ::errors::format_to
+        /// only once for all references to it.
+        [[nodiscard]]
+        const std::string &str() const
+        {
+                static const std::string none = "no error";
+                if (this->entry == nullptr) {
+                        return none;
+                }
+
+                auto &entry = *this->entry;
+                std::call_once(entry.formatted, [&entry]() {
+                        format_to(entry.text, entry.err);
+                });
+                return entry.text;
+        }
+
+    private:
+        friend class intern_table;
+
+        explicit interned_error(
+                std::shared_ptr<detail::interned_entry> entry) noexcept
+                : entry(std::move(entry))
+        {
+        }
+
+        std::shared_ptr<detail::interned_entry> entry;
+};
+
+/// @brief
+/// A table which deduplicates identical error chains.
+///
+/// @details
+/// Two chains are identical
+/// if their errors have the same dynamic types,
+/// source locations, messages
+/// and codes for ::errors::impl::code_error<int>,
+/// in the same order.
+/// Frames recorded by ::errors::trace are compared one by one.
+///
+/// Interning a chain which is already in the table
+/// destroys the new chain and returns a reference to the old one,
+/// so memory and formatting cost
+/// scale with the number of distinct errors
+/// instead of the number of errors.
+///
+/// This class is thread-safe.
+///
+/// @note
+/// Interned errors are immutable and shared,
+/// use them for reporting, not for building further chains.
+class intern_table {
+    public:
+        /// @brief
+        /// Create an empty table.
+        ///
+        /// @param capacity
+        /// The maximum number of distinct chains kept by the table.
+        /// Chains interned after the table is full are not shared.
+        explicit intern_table(std::size_t capacity = 4096)
+                : capacity(capacity)
+        {
+        }
+
+        intern_table(const intern_table &) = delete;
+        intern_table(intern_table &&) = delete;
+        intern_table &operator=(const intern_table &) = delete;
+        intern_table &operator=(intern_table &&) = delete;
+
+        /// @brief
+        /// Intern an error chain.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @return
+        /// A reference to the identical chain in the table if any,
+        /// otherwise a reference to `err`.
+        interned_error intern(error_ptr &&err)
+        {
+                if (!err) {
+                        return interned_error();
+                }
+
+                auto hash = detail::hash_chain(err.get());
+
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto range = this->entries.equal_range(hash);
+                for (auto it = range.first; it != range.second; ++it) {
+                        auto &entry = it->second;
+                        if (detail::equal_chain(entry->err.get(),
+                                                err.get())) {
+                                entry->count.fetch_add(
+                                        1, std::memory_order_relaxed);
+                                return interned_error(entry);
+                        }
+                }
+
+                auto entry = std::make_shared<detail::interned_entry>(
+                        std::move(err));
+                if (this->entries.size() < this->capacity) {
+                        this->entries.emplace(hash, entry);
+                }
+                return interned_error(std::move(entry));
+        }
+
+        /// @brief
+        /// Get the number of distinct chains in the table.
+        [[nodiscard]]
+        std::size_t size() const
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->entries.size();
+        }
+
+        /// @brief
+        /// Remove all chains from the table.
+        ///
+        /// @details
+        /// Chains still referenced by ::errors::interned_error
+        /// are kept alive by those references.
+        void clear()
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->entries.clear();
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::size_t capacity;
+        std::unordered_multimap<std::size_t,
+                                std::shared_ptr<detail::interned_entry>>
+                entries;
+};
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "errors/error_ptr.hpp"
+#include "errors/impl/joined_error.hpp"
+#include "errors/literal.hpp"
+#include "errors/make.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// Errors of a batch operation to be joined by ::errors::join.
+///
+/// @details
+/// An item which needs a whole error is added as an ::errors::error_ptr,
+/// an item which only needs a code and a static message
+/// is added as a compact ::errors::impl::batch_entry,
+/// so entries of all items share one allocation.
+class batch {
+    public:
+        /// @brief
+        /// Reserve space for entries.
+        ///
+        /// @param entries
+        /// The number of entries to be added.
+        void reserve(std::size_t entries)
+        {
+                this->entries.reserve(entries);
+        }
+
+        /// @brief
+        /// Add an error.
+        ///
+        /// @param err
+        /// The error, ignored if it is `nullptr`.
+        void add(error_ptr &&err)
+        {
+                if (err != nullptr) {
+                        this->causes.push_back(std::move(err));
+                }
+        }
+
+        /// @brief
+        /// Add an entry for a failed item.
+        ///
+        /// @param index
+        /// The index of the item.
+        ///
+        /// @param code
+        /// The error code.
+        ///
+        /// @param message
+        /// The string literal.
+        void add(std::uint32_t index, int code, literal message)
+        {
+                this->entries.push_back({ index, code, message });
+        }
+
+        /// @brief
+        /// Get the number of errors and entries added.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->causes.size() + this->entries.size();
+        }
+
+        /// @brief
+        /// Check if nothing has been added.
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+                return this->size() == 0;
+        }
+
+    private:
+        friend class join;
+
+        std::vector<error_ptr> causes;
+        std::vector<impl::batch_entry> entries;
+};
+
+/// @brief
+/// A function like class to join errors of a batch.
+///
+/// @details
+/// It creates an ::errors::impl::joined_error,
+/// or `nullptr` if the batch is empty.
+///
+/// @see ::errors::batch
+class join : public error_ptr {
+    public:
+        /// @brief
+        /// Join errors with a message.
+        join(std::string message, batch &&errors,
+             source_location location = source_location::current())
+                : error_ptr(errors.empty() ? nullptr :
+                                             make(std::move(message),
+                                                  std::move(errors),
+                                                  std::move(location)))
+        {
+        }
+
+        /// @brief
+        /// Join errors with a null-terminated message.
+        ///
+        /// @details
+        /// The message is copied,
+        /// pass ::ERRORS_LITERAL to keep a pointer to a string literal
+        /// instead.
+        join(const char *message, batch &&errors,
+             source_location location = source_location::current())
+                : join(std::string(message), std::move(errors),
+                       std::move(location))
+        {
+        }
+
+        /// @brief
+        /// Join errors with a string literal as message.
+        ///
+        /// @details
+        /// The literal is not copied.
+        ///
+        /// @see ::errors::literal
+        join(literal message, batch &&errors,
+             source_location location = source_location::current())
+                : error_ptr(errors.empty() ? nullptr :
+                                             make(message, std::move(errors),
+                                                  std::move(location)))
+        {
+        }
+
+        /// @brief
+        /// Join errors.
+        join(batch &&errors,
+             source_location location = source_location::current())
+                : join(ERRORS_LITERAL(""), std::move(errors),
+                       std::move(location))
+        {
+        }
+
+    private:
+        template <typename Message>
+        static error_ptr make(Message message, batch &&errors,
+                              source_location location)
+        {
+                return detail::make<impl::joined_error>::with(
+                        std::move(message), std::move(errors.causes),
+                        std::move(errors.entries), std::move(location));
+        }
+};
+
+}
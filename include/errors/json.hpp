@@ -1,11 +1,37 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <optional>
 
 #include "errors/error_ptr.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/trace_error.hpp"
 #include "errors/source_location.hpp"
 #include "nlohmann/json.hpp"
 
+namespace errors
+{
+namespace detail
+{
+/// @cond
+inline void stacktrace_to_json(nlohmann::json &j, const error *err)
+{
+        const auto *stack = stacktrace_of(err);
+        if (stack == nullptr) {
+                return;
+        }
+
+        auto &symbols = j["stacktrace"];
+        symbols = nlohmann::json::array();
+        for (std::size_t i = 0; i < stack->size(); ++i) {
+                symbols.push_back(stack->symbol(i));
+        }
+}
+/// @endcond
+}
+}
+
 #if defined(NLOHMANN_JSON_NAMESPACE_BEGIN) && \
         defined(NLOHMANN_JSON_NAMESPACE_END)
 NLOHMANN_JSON_NAMESPACE_BEGIN
@@ -36,13 +62,37 @@ struct adl_serializer< ::errors::error_ptr> {
                         return;
                 }
 
-                if (err->location()) {
-                        j["location"] = err->location().value();
-                }
-
-                j["message"] = err->what();
+                // NOTE:
+                // Fill the nested objects in place from the outermost one,
+                // instead of converting each cause recursively
+                // and copying it into its parent.
+                auto *node = &j;
+                for (const auto *current = err.get(); current != nullptr;
+                     current = current->cause().get()) {
+                        // NOTE:
+                        // Expand frames recorded by errors::trace,
+                        // so the output is the same as wrapping the error
+                        // without a message on each frame.
+                        const auto *trace = ::errors::detail::cast<
+                                ::errors::impl::trace_error>(current);
+                        if (trace != nullptr) {
+                                for (std::size_t i = 0; i < trace->size();
+                                     ++i) {
+                                        (*node)["location"] = trace->frame(i);
+                                        (*node)["message"] = "";
+                                        node = &(*node)["caused_by"];
+                                }
+                                continue;
+                        }
 
-                j["caused_by"] = err->cause();
+                        auto location = current->location();
+                        if (location) {
+                                (*node)["location"] = location.value();
+                        }
+                        (*node)["message"] = current->what();
+                        ::errors::detail::stacktrace_to_json(*node, current);
+                        node = &(*node)["caused_by"];
+                }
         }
 };
 
@@ -52,3 +102,62 @@ NLOHMANN_JSON_NAMESPACE_END
 #else
 }
 #endif
+
+namespace errors
+{
+
+/// @brief
+/// Convert an error chain to a flat JSON array.
+///
+/// @details
+/// Each error is an object with `location` and `message`,
+/// from the outermost error to the innermost one,
+/// frames recorded by ::errors::trace are expanded
+/// as errors without message,
+/// and an error with a stack trace
+/// recorded by ::errors::sample_stacktraces
+/// also has `stacktrace`, an array of symbols.
+/// A null error is an empty array.
+///
+/// This form is cheaper to build and to index than `nlohmann::json(err)`.
+/// Dumping `nlohmann::json` recurses once per level of nesting,
+/// and so does destroying it with old versions of nlohmann_json,
+/// so for very deep chains
+/// prefer this form or ::errors::write_json,
+/// which does not recurse at all.
+///
+/// @param err
+/// The error chain.
+///
+/// @return
+/// The JSON array.
+[[nodiscard]]
+inline nlohmann::json flat_json(const error_ptr &err)
+{
+        auto result = nlohmann::json::array();
+        for (const auto *current = err.get(); current != nullptr;
+             current = current->cause().get()) {
+                const auto *trace = detail::cast<impl::trace_error>(current);
+                if (trace != nullptr) {
+                        for (std::size_t i = 0; i < trace->size(); ++i) {
+                                result.push_back({
+                                        { "location", trace->frame(i) },
+                                        { "message", "" },
+                                });
+                        }
+                        continue;
+                }
+
+                result.push_back(nlohmann::json::object());
+                auto &item = result.back();
+                auto location = current->location();
+                if (location) {
+                        item["location"] = location.value();
+                }
+                item["message"] = current->what();
+                detail::stacktrace_to_json(item, current);
+        }
+        return result;
+}
+
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "errors/detail/bounded_sink.hpp"
+#include "errors/error_ptr.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// The layout of an error chain written by ::errors::write_json.
+enum class json_form {
+        /// @brief
+        /// Each error is an object with `caused_by`, `location` and `message`,
+        /// its cause is nested in `caused_by`.
+        /// An error with a stack trace
+        /// recorded by ::errors::sample_stacktraces
+        /// also has `stacktrace`, an array of symbols.
+        nested,
+        /// @brief
+        /// The chain is an array of objects with `location` and `message`,
+        /// from the outermost error to the innermost one.
+        flat,
+};
+
+namespace detail
+{
+
+/// @cond
+template <typename Sink>
+class json_writer {
+    public:
+        explicit json_writer(Sink &sink) noexcept
+                : sink(sink)
+        {
+        }
+
+        void write(const error *err, json_form form)
+        {
+                if (form == json_form::flat) {
+                        this->write_flat(err);
+                        return;
+                }
+                this->write_nested(err);
+        }
+
+    private:
+        static constexpr std::size_t inline_depth = 32;
+
+        Sink &sink;
+        std::array<const error *, inline_depth> stack;
+        std::vector<const error *> spilled;
+
+        void write_flat(const error *err)
+        {
+                this->put("[");
+                for (bool first = true; err != nullptr;
+                     err = err->cause().get()) {
+                        const auto *trace = cast<impl::trace_error>(err);
+                        auto frames = trace == nullptr ? 1 : trace->size();
+                        for (std::size_t i = 0; i < frames; ++i) {
+                                if (!first) {
+                                        this->put(",");
+                                }
+                                first = false;
+                                this->put("{");
+                                if (trace == nullptr) {
+                                        this->write_fields(err);
+                                } else {
+                                        this->write_fields(trace->frame(i),
+                                                           "");
+                                }
+                        }
+                }
+                this->put("]");
+        }
+
+        void write_nested(const error *err)
+        {
+                if (err == nullptr) {
+                        this->put("null");
+                        return;
+                }
+
+                // NOTE:
+                // Keys are written in the order of nlohmann::json,
+                // which sorts them, so `caused_by` comes first
+                // and the message of an error can only be written
+                // after all of its causes.
+                // Errors are pushed to a stack while going down the chain,
+                // then popped to close their objects.
+                std::size_t depth = 0;
+                for (; err != nullptr; err = err->cause().get()) {
+                        this->push(depth++, err);
+
+                        const auto *trace = cast<impl::trace_error>(err);
+                        auto frames = trace == nullptr ? 1 : trace->size();
+                        for (std::size_t i = 0; i < frames; ++i) {
+                                this->put("{\"caused_by\":");
+                        }
+                }
+
+                this->put("null");
+
+                while (depth != 0) {
+                        err = this->at(--depth);
+
+                        // NOTE:
+                        // Expand frames recorded by errors::trace,
+                        // so the output is the same as wrapping the error
+                        // without a message on each frame.
+                        const auto *trace = cast<impl::trace_error>(err);
+                        if (trace == nullptr) {
+                                this->put(",");
+                                this->write_fields(err);
+                                continue;
+                        }
+
+                        for (auto i = trace->size(); i != 0; --i) {
+                                this->put(",");
+                                this->write_fields(trace->frame(i - 1), "");
+                        }
+                }
+        }
+
+        void push(std::size_t index, const error *err)
+        {
+                if (index < inline_depth) {
+                        this->stack[index] = err;
+                        return;
+                }
+                this->spilled.push_back(err);
+        }
+
+        const error *at(std::size_t index) const noexcept
+        {
+                if (index < inline_depth) {
+                        return this->stack[index];
+                }
+                return this->spilled[index - inline_depth];
+        }
+
+        void put(const char *data, std::size_t size)
+        {
+                this->sink(data, size);
+        }
+
+        template <std::size_t N>
+        void put(const char (&str)[N])
+        {
+                this->put(str, N - 1);
+        }
+
+        void write_number(std::uint_least32_t value)
+        {
+                char buffer[16];
+                auto result =
+                        std::to_chars(buffer, buffer + sizeof(buffer), value);
+                this->put(buffer, result.ptr - buffer);
+        }
+
+        static std::size_t utf8_sequence(const unsigned char *str) noexcept
+        {
+                // NOTE:
+                // Return the length of a valid UTF-8 sequence
+                // starting with a non-ASCII byte,
+                // or `0` if it is invalid.
+                auto lead = str[0];
+                unsigned char low = 0x80;
+                unsigned char high = 0xBF;
+                std::size_t length = 0;
+
+                if (lead >= 0xC2 && lead <= 0xDF) {
+                        length = 2;
+                } else if (lead >= 0xE0 && lead <= 0xEF) {
+                        length = 3;
+                        low = lead == 0xE0 ? 0xA0 : low;
+                        high = lead == 0xED ? 0x9F : high;
+                } else if (lead >= 0xF0 && lead <= 0xF4) {
+                        length = 4;
+                        low = lead == 0xF0 ? 0x90 : low;
+                        high = lead == 0xF4 ? 0x8F : high;
+                } else {
+                        return 0;
+                }
+
+                if (str[1] < low || str[1] > high) {
+                        return 0;
+                }
+                for (std::size_t i = 2; i < length; ++i) {
+                        if (str[i] < 0x80 || str[i] > 0xBF) {
+                                return 0;
+                        }
+                }
+                return length;
+        }
+
+        void write_string(const char *str)
+        {
+                static constexpr char hex[] = "0123456789abcdef";
+
+                this->put("\"");
+
+                const auto *begin = str;
+                const auto *current =
+                        reinterpret_cast<const unsigned char *>(str);
+                while (*current != '\0') {
+                        auto c = *current;
+                        if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80) {
+                                ++current;
+                                continue;
+                        }
+
+                        if (c >= 0x80) {
+                                auto length = utf8_sequence(current);
+                                if (length != 0) {
+                                        current += length;
+                                        continue;
+                                }
+                        }
+
+                        this->put(begin, reinterpret_cast<const char *>(
+                                                 current) -
+                                                 begin);
+
+                        switch (c) {
+                        case '"':
+                                this->put("\\\"");
+                                break;
+                        case '\\':
+                                this->put("\\\\");
+                                break;
+                        case '\b':
+                                this->put("\\b");
+                                break;
+                        case '\f':
+                                this->put("\\f");
+                                break;
+                        case '\n':
+                                this->put("\\n");
+                                break;
+                        case '\r':
+                                this->put("\\r");
+                                break;
+                        case '\t':
+                                this->put("\\t");
+                                break;
+                        default:
+                                if (c < 0x20) {
+                                        const char escaped[] = {
+                                                '\\', 'u', '0', '0',
+                                                hex[c >> 4], hex[c & 0xF]
+                                        };
+                                        this->put(escaped, sizeof(escaped));
+                                } else {
+                                        // U+FFFD REPLACEMENT CHARACTER
+                                        this->put("\xEF\xBF\xBD");
+                                }
+                        }
+
+                        ++current;
+                        begin = reinterpret_cast<const char *>(current);
+                }
+
+                this->put(begin,
+                          reinterpret_cast<const char *>(current) - begin);
+                this->put("\"");
+        }
+
+        void write_location(const source_location &location)
+        {
+                this->put("{\"column\":");
+                this->write_number(location.column());
+                this->put(",\"file_name\":");
+                this->write_string(location.file_name());
+                this->put(",\"function_name\":");
+                this->write_string(location.function_name());
+                this->put(",\"line\":");
+                this->write_number(location.line());
+                this->put("}");
+        }
+
+        void write_fields(const std::optional<source_location> &location,
+                          const char *message)
+        {
+                this->write_fields(location, message, nullptr);
+        }
+
+        void write_fields(const error *err)
+        {
+                this->write_fields(err->location(), err->what(),
+                                   stacktrace_of(err));
+        }
+
+        void write_fields(const std::optional<source_location> &location,
+                          const char *message,
+                          const impl::stacktrace *stack)
+        {
+                if (location) {
+                        this->put("\"location\":");
+                        this->write_location(location.value());
+                        this->put(",");
+                }
+                this->put("\"message\":");
+                this->write_string(message);
+                if (stack != nullptr) {
+                        this->put(",\"stacktrace\":[");
+                        for (std::size_t i = 0; i < stack->size(); ++i) {
+                                if (i != 0) {
+                                        this->put(",");
+                                }
+                                this->write_string(stack->symbol(i));
+                        }
+                        this->put("]");
+                }
+                this->put("}");
+        }
+};
+/// @endcond
+
+}
+
+/// @brief
+/// Write an error chain as JSON to a `std::ostream`.
+///
+/// @details
+/// The output is the same as dumping `nlohmann::json(err)`
+/// or ::errors::flat_json in the compact form,
+/// a null error is `null` or `[]`.
+/// Unlike the `nlohmann::json` serializer,
+/// no intermediate object is built
+/// and the chain is walked without recursion,
+/// so chains of any depth can be written.
+/// Only ::errors::json_form::nested allocates,
+/// and only for chains deeper than 32 errors.
+///
+/// Invalid UTF-8 sequences in messages and source locations
+/// are replaced by U+FFFD,
+/// where dumping `nlohmann::json` would throw.
+///
+/// This function does not require `nlohmann::json`.
+///
+/// @param os
+/// The output stream.
+///
+/// @param err
+/// The error chain.
+///
+/// @param form
+/// The layout of the output.
+///
+/// @return
+/// `os`.
+inline std::ostream &write_json(std::ostream &os, const error_ptr &err,
+                                json_form form = json_form::nested)
+{
+        auto sink = [&os](const char *data, std::size_t size) {
+                os.write(data, static_cast<std::streamsize>(size));
+        };
+        detail::json_writer<decltype(sink)>(sink).write(err.get(), form);
+        return os;
+}
+
+/// @brief
+/// Append an error chain as JSON to a string.
+///
+/// @details
+/// See ::errors::write_json(std::ostream &, const error_ptr &, json_form)
+/// for the output.
+///
+/// @param out
+/// The string to append to.
+///
+/// @param err
+/// The error chain.
+///
+/// @param form
+/// The layout of the output.
+inline void write_json(std::string &out, const error_ptr &err,
+                       json_form form = json_form::nested)
+{
+        auto sink = [&out](const char *data, std::size_t size) {
+                out.append(data, size);
+        };
+        detail::json_writer<decltype(sink)>(sink).write(err.get(), form);
+}
+
+/// @brief
+/// Write an error chain as JSON to a caller provided buffer.
+///
+/// @details
+/// See ::errors::write_json(std::ostream &, const error_ptr &, json_form)
+/// for the output.
+///
+/// Like `std::snprintf`, at most `size` bytes are written
+/// and the whole length is returned,
+/// so a return value greater than `size` means
+/// the output is truncated
+/// and a buffer of that size is required.
+/// Unlike `std::snprintf`, no terminating null character is written.
+///
+/// @param buffer
+/// The buffer, it can be `nullptr` if `size` is `0`.
+///
+/// @param size
+/// The size of the buffer.
+///
+/// @param err
+/// The error chain.
+///
+/// @param form
+/// The layout of the output.
+///
+/// @return
+/// The length of the whole output.
+inline std::size_t write_json(char *buffer, std::size_t size,
+                              const error_ptr &err,
+                              json_form form = json_form::nested)
+{
+        detail::bounded_sink sink(buffer, size);
+        detail::json_writer<detail::bounded_sink>(sink).write(err.get(), form);
+        return sink.size();
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace errors
+{
+
+namespace detail
+{
+/// @cond
+struct literal_tag {};
+/// @endcond
+}
+
+/// @brief
+/// A message which refers to a string literal.
+///
+/// @details
+/// Builtin error types constructed from a literal
+/// keep the pointer to the literal instead of copying the text.
+///
+/// Create it with ::ERRORS_LITERAL,
+/// which only accepts string literals:
+///
+/// ```cpp
+/// auto err = errors::make<errors::impl::runtime_error>::with(
+///         ERRORS_LITERAL("failed to read config"));
+/// ```
+class literal {
+    public:
+        /// @brief
+        /// Refer to a string literal.
+        ///
+        /// @details
+        /// Use ::ERRORS_LITERAL instead of calling it directly.
+        ///
+        /// @param text
+        /// The string literal,
+        /// which **MUST** have static storage duration.
+        constexpr literal(detail::literal_tag, const char *text) noexcept
+                : text(text)
+                , length(std::char_traits<char>::length(text))
+        {
+        }
+
+        /// @brief
+        /// Get the null-terminated text.
+        [[nodiscard]]
+        constexpr const char *c_str() const noexcept
+        {
+                return this->text;
+        }
+
+        /// @brief
+        /// Get the length of the text.
+        [[nodiscard]]
+        constexpr std::size_t size() const noexcept
+        {
+                return this->length;
+        }
+
+        /// @brief
+        /// Get the text.
+        [[nodiscard]]
+        constexpr std::string_view view() const noexcept
+        {
+                return std::string_view(this->text, this->length);
+        }
+
+    private:
+        const char *text;
+        std::size_t length;
+};
+
+}
+
+/// @brief
+/// Create an ::errors::literal from a string literal.
+///
+/// @details
+/// Anything but a string literal fails to compile,
+/// so the text always outlives the errors referring to it.
+///
+/// @param text
+/// The string literal.
+#define ERRORS_LITERAL(text)                                                 \
+        ::errors::literal(::errors::detail::literal_tag(), "" text)
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
 
 #include "errors/error_ptr.hpp"
+#include "errors/memory_resource.hpp"
 #include "errors/source_location.hpp"
+#include "errors/stacktrace.hpp"
+
+#if defined(ERRORS_ENABLE_METRICS)
+#include "errors/metrics.hpp"
+#endif
 
 namespace errors
 {
@@ -23,7 +30,9 @@ class make {
         template <typename... Args>
         struct with : public error_ptr {
                 with(Args... args)
-                        : error_ptr(std::make_unique<E>(std::move(args)...))
+                        : error_ptr(detail::allocate<E>(
+                                  current_memory_resource(),
+                                  std::move(args)...))
                 {
                 }
         };
@@ -60,13 +69,38 @@ class make {
                 /// It captures the source location from where it is called,
                 /// and passes it as the last argument
                 /// with anything you pass to the error constructor.
+                ///
+                /// The error might record a stack trace,
+                /// see ::errors::sample_stacktraces,
+                /// and it is counted if `ERRORS_ENABLE_METRICS` is defined,
+                /// see ::errors::snapshot_metrics.
                 with(Args... args,
                      source_location location = source_location::current())
-                        : error_ptr(static_cast<error_ptr>(
-                                  typename detail::make<E>::with(
-                                          std::move(args)...,
-                                          std::move(location))))
+                        : error_ptr(create(std::move(args)...,
+                                           std::move(location)))
+                {
+                }
+
+            private:
+                // NOTE:
+                // Take references,
+                // so the arguments are moved only once
+                // into detail::make::with like before.
+                static error_ptr create(Args &&...args,
+                                        source_location &&location)
                 {
+#if defined(ERRORS_ENABLE_METRICS)
+                        detail::count_error<E>(location);
+#endif
+                        if constexpr (!std::is_final_v<E>) {
+                                if (detail::sample_stacktrace<E>()) {
+                                        return detail::make_sampled<E>(
+                                                std::move(args)...,
+                                                std::move(location));
+                                }
+                        }
+                        return typename detail::make<E>::with(
+                                std::move(args)..., std::move(location));
                 }
         };
         /// @example examples/basic-usage/src/main.cpp
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "errors/detail/deleter.hpp"
+#include "errors/error_ptr.hpp"
+
+namespace errors
+{
+namespace detail
+{
+
+/// @cond
+inline std::pmr::memory_resource *&thread_memory_resource() noexcept
+{
+        thread_local std::pmr::memory_resource *resource = nullptr;
+        return resource;
+}
+
+template <typename E>
+constexpr std::size_t allocation_alignment() noexcept
+{
+        return std::max(alignof(E), alignof(allocation_header));
+}
+
+template <typename E>
+constexpr std::size_t allocation_offset() noexcept
+{
+        constexpr auto alignment = allocation_alignment<E>();
+        return (sizeof(allocation_header) + alignment - 1) / alignment *
+               alignment;
+}
+
+template <typename E>
+constexpr std::size_t allocation_size() noexcept
+{
+        return allocation_offset<E>() + sizeof(E);
+}
+
+template <typename E, typename... Args>
+error_ptr allocate(std::pmr::memory_resource *resource, Args &&...args)
+{
+        if (resource == nullptr) {
+                return error_ptr(
+                        std::make_unique<E>(std::forward<Args>(args)...));
+        }
+
+        constexpr auto alignment = allocation_alignment<E>();
+        constexpr auto offset = allocation_offset<E>();
+        constexpr auto size = allocation_size<E>();
+
+        auto *storage =
+                static_cast<char *>(resource->allocate(size, alignment));
+        auto *object = storage + offset;
+        new (object - sizeof(allocation_header))
+                allocation_header{ size, alignment, offset };
+
+        E *err = nullptr;
+        try {
+                err = new (object) E(std::forward<Args>(args)...);
+        } catch (...) {
+                resource->deallocate(storage, size, alignment);
+                throw;
+        }
+
+        return error_ptr(err, deleter(resource));
+}
+/// @endcond
+
+}
+
+/// @brief
+/// Get the memory resource used by current thread to allocate errors.
+///
+/// @return
+/// The memory resource set by the innermost alive
+/// ::errors::memory_resource_scope of current thread,
+/// or `nullptr` if errors are allocated by `new`.
+[[nodiscard]]
+inline std::pmr::memory_resource *current_memory_resource() noexcept
+{
+        return detail::thread_memory_resource();
+}
+
+/// @brief
+/// Allocate errors created in current thread from a memory resource.
+///
+/// @details
+/// While an instance of this class is alive,
+/// ::errors::make::with and ::errors::wrap called from current thread
+/// allocate errors from the given memory resource
+/// instead of calling `new`.
+/// Scopes can be nested,
+/// the previous resource is restored when the scope ends.
+///
+/// Each ::errors::error_ptr remembers the resource its error came from,
+/// so errors from different resources can be mixed in one chain.
+///
+/// Combined with a `std::pmr::monotonic_buffer_resource`,
+/// deallocation of a whole chain is a no-op
+/// and all the memory is given back in one step
+/// by releasing the resource.
+///
+/// @warning
+/// The resource **MUST** outlive all errors allocated from it.
+///
+/// @note
+/// Messages of builtin errors longer than
+/// ::errors::impl::inline_message::inline_capacity
+/// are still allocated by `new`.
+class memory_resource_scope {
+    public:
+        /// @brief
+        /// Start allocating errors from `resource` in current thread.
+        ///
+        /// @param resource
+        /// The memory resource,
+        /// `nullptr` means allocating errors by `new`.
+        explicit memory_resource_scope(
+                std::pmr::memory_resource *resource) noexcept
+                : previous(std::exchange(detail::thread_memory_resource(),
+                                         resource))
+        {
+        }
+
+        ~memory_resource_scope()
+        {
+                detail::thread_memory_resource() = this->previous;
+        }
+
+        memory_resource_scope(const memory_resource_scope &) = delete;
+        memory_resource_scope(memory_resource_scope &&) = delete;
+        memory_resource_scope &operator=(const memory_resource_scope &) = delete;
+        memory_resource_scope &operator=(memory_resource_scope &&) = delete;
+
+    private:
+        std::pmr::memory_resource *previous;
+};
+
+}
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define ERRORS_HAS_CXXABI 1
+#endif
+
+#include "errors/source_location.hpp"
+#include "errors/source_site.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// The number of errors of a type created at a call site.
+///
+/// @see ::errors::snapshot_metrics
+struct error_metric {
+        /// @brief
+        /// The error type passed to ::errors::make,
+        /// ::errors::impl::wrap_error for ::errors::wrap,
+        /// or `nullptr` for errors counted after
+        /// the table of a thread is full.
+        const std::type_info *type;
+        /// @brief
+        /// The call site.
+        source_site site;
+        /// @brief
+        /// The number of errors.
+        std::uint64_t count;
+};
+
+namespace detail
+{
+
+/// @cond
+class metrics_shard {
+    public:
+        void add(const std::type_info &type, source_site site) noexcept
+        {
+                auto key = reinterpret_cast<std::uintptr_t>(&type) ^
+                           (static_cast<std::uintptr_t>(site.id()) *
+                            0x9e3779b97f4a7c15ULL);
+                auto start = static_cast<std::size_t>(key ^ (key >> 17));
+                for (std::size_t i = 0; i < max_probes; ++i) {
+                        auto &entry = this->entries[(start + i) & mask];
+                        if (entry.state.load(std::memory_order_relaxed) ==
+                            empty) {
+                                // NOTE:
+                                // Only the owner thread writes entries,
+                                // readers wait for them to be ready.
+                                entry.type = &type;
+                                entry.site = site;
+                                entry.state.store(ready,
+                                                  std::memory_order_release);
+                                increment(entry.count);
+                                return;
+                        }
+                        if (entry.type == &type && entry.site == site) {
+                                increment(entry.count);
+                                return;
+                        }
+                }
+                increment(this->overflow);
+        }
+
+        template <typename Fn>
+        void visit(Fn &&fn) const
+        {
+                for (const auto &entry : this->entries) {
+                        if (entry.state.load(std::memory_order_acquire) !=
+                            ready) {
+                                continue;
+                        }
+                        fn(entry.type, entry.site,
+                           entry.count.load(std::memory_order_relaxed));
+                }
+                auto overflow = this->overflow.load(std::memory_order_relaxed);
+                if (overflow != 0) {
+                        fn(nullptr, source_site(), overflow);
+                }
+        }
+
+    private:
+        static constexpr std::size_t capacity = 1024;
+        static constexpr std::size_t mask = capacity - 1;
+        static constexpr std::size_t max_probes = 16;
+
+        enum : std::uint32_t { empty = 0, ready = 1 };
+
+        struct entry_t {
+                std::atomic<std::uint32_t> state{ empty };
+                source_site site;
+                const std::type_info *type = nullptr;
+                std::atomic<std::uint64_t> count{ 0 };
+        };
+
+        static void increment(std::atomic<std::uint64_t> &count) noexcept
+        {
+                // NOTE:
+                // Only the owner thread writes counters,
+                // a load and a store are enough
+                // and cheaper than a read-modify-write.
+                count.store(count.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        }
+
+        alignas(64) entry_t entries[capacity];
+        alignas(64) std::atomic<std::uint64_t> overflow{ 0 };
+};
+
+class metrics_registry {
+    public:
+        using key_t = std::pair<const std::type_info *, source_site>;
+
+        static metrics_registry &instance()
+        {
+                // NOTE:
+                // Never destroyed,
+                // so threads exiting after main can still retire shards.
+                static auto *registry = new metrics_registry();
+                return *registry;
+        }
+
+        void attach(metrics_shard *shard)
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->shards.push_back(shard);
+        }
+
+        void retire(metrics_shard *shard)
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                shard->visit([this](const std::type_info *type,
+                                    source_site site, std::uint64_t count) {
+                        this->retired[{ type, site }] += count;
+                });
+                this->shards.erase(std::remove(this->shards.begin(),
+                                               this->shards.end(), shard),
+                                   this->shards.end());
+        }
+
+        std::map<key_t, std::uint64_t> collect()
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto result = this->retired;
+                for (const auto *shard : this->shards) {
+                        shard->visit([&result](const std::type_info *type,
+                                               source_site site,
+                                               std::uint64_t count) {
+                                result[{ type, site }] += count;
+                        });
+                }
+                return result;
+        }
+
+    private:
+        metrics_registry() = default;
+
+        std::mutex mutex;
+        std::vector<metrics_shard *> shards;
+        std::map<key_t, std::uint64_t> retired;
+};
+
+class local_metrics {
+    public:
+        local_metrics(const local_metrics &) = delete;
+        local_metrics(local_metrics &&) = delete;
+        local_metrics &operator=(const local_metrics &) = delete;
+        local_metrics &operator=(local_metrics &&) = delete;
+
+        static metrics_shard *get()
+        {
+                // NOTE:
+                // Only the first call of a thread
+                // pays for the guard of the owner,
+                // which retires the shard when the thread exits.
+                if (current != nullptr || exited) {
+                        return current;
+                }
+                thread_local local_metrics owner;
+                return current;
+        }
+
+    private:
+        local_metrics()
+                : shard(std::make_unique<metrics_shard>())
+        {
+                metrics_registry::instance().attach(this->shard.get());
+                current = this->shard.get();
+        }
+
+        ~local_metrics()
+        {
+                current = nullptr;
+                exited = true;
+                metrics_registry::instance().retire(this->shard.get());
+        }
+
+        static inline thread_local metrics_shard *current = nullptr;
+        static inline thread_local bool exited = false;
+
+        std::unique_ptr<metrics_shard> shard;
+};
+
+inline void record_error(const std::type_info &type,
+                         const source_location &location) noexcept
+{
+        try {
+                auto *shard = local_metrics::get();
+                if (shard != nullptr) {
+                        shard->add(type, source_site(location));
+                }
+        } catch (...) {
+                // NOTE:
+                // Failed to allocate the shard of current thread,
+                // do not count.
+        }
+}
+
+template <typename E>
+inline void count_error(const source_location &location) noexcept
+{
+#if defined(ERRORS_ENABLE_METRICS)
+        record_error(typeid(E), location);
+#else
+        static_cast<void>(location);
+#endif
+}
+
+inline std::string type_name(const std::type_info *type)
+{
+        if (type == nullptr) {
+                return "";
+        }
+#if defined(ERRORS_HAS_CXXABI)
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> name(
+                abi::__cxa_demangle(type->name(), nullptr, nullptr, &status),
+                &std::free);
+        if (status == 0 && name != nullptr) {
+                return name.get();
+        }
+#endif
+        return type->name();
+}
+
+inline void append_label(std::string &out, const char *name,
+                         const std::string &value)
+{
+        out += name;
+        out += "=\"";
+        for (auto c : value) {
+                switch (c) {
+                case '\\':
+                        out += "\\\\";
+                        break;
+                case '"':
+                        out += "\\\"";
+                        break;
+                case '\n':
+                        out += "\\n";
+                        break;
+                default:
+                        out += c;
+                }
+        }
+        out += '"';
+}
+/// @endcond
+
+}
+
+/// @brief
+/// Get the numbers of errors created by each type and call site.
+///
+/// @details
+/// Define `ERRORS_ENABLE_METRICS`
+/// before including any header files from `errors`
+/// to count errors created by ::errors::make::with and ::errors::wrap.
+/// Without it the counting compiles to nothing
+/// and this function returns an empty vector.
+///
+/// Each thread counts into its own table,
+/// keyed by the error type and the call site interned as
+/// ::errors::source_site,
+/// so counting is a lookup in thread local memory
+/// without any read-modify-write.
+/// Snapshots add up the tables of all threads,
+/// counts of exited threads included.
+///
+/// @warning
+/// `ERRORS_ENABLE_METRICS` changes inline functions
+/// used by all translation units,
+/// so it **MUST** be defined the same way
+/// in all translation units of a program.
+///
+/// @return
+/// The metrics, the largest count first.
+[[nodiscard]]
+inline std::vector<error_metric> snapshot_metrics()
+{
+        auto collected = detail::metrics_registry::instance().collect();
+
+        std::vector<error_metric> result;
+        result.reserve(collected.size());
+        for (const auto &[key, count] : collected) {
+                result.push_back({ key.first, key.second, count });
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const error_metric &lhs, const error_metric &rhs) {
+                          if (lhs.count != rhs.count) {
+                                  return lhs.count > rhs.count;
+                          }
+                          return lhs.site < rhs.site;
+                  });
+        return result;
+}
+
+/// @brief
+/// Append metrics in the Prometheus text format to a string.
+///
+/// @details
+/// It writes one counter `errors_created_total`
+/// labeled by `type`, `file`, `function`, `line` and `column`,
+/// like
+/// `errors_created_total{type="errors::impl::runtime_error",`
+/// `file="main.cpp",function="int main()",line="42",column="9"} 7`.
+///
+/// @param out
+/// The string to append to.
+///
+/// @param metrics
+/// The metrics returned by ::errors::snapshot_metrics.
+inline void write_prometheus(std::string &out,
+                             const std::vector<error_metric> &metrics)
+{
+        out += "# HELP errors_created_total "
+               "Errors created by errors::make and errors::wrap.\n"
+               "# TYPE errors_created_total counter\n";
+        for (const auto &metric : metrics) {
+                auto location = metric.site.location();
+                out += "errors_created_total{";
+                detail::append_label(out, "type",
+                                     detail::type_name(metric.type));
+                out += ',';
+                detail::append_label(out, "file",
+                                     location ? location->file_name() : "");
+                out += ',';
+                detail::append_label(out, "function",
+                                     location ? location->function_name() :
+                                                "");
+                out += ',';
+                detail::append_label(
+                        out, "line",
+                        std::to_string(location ? location->line() : 0));
+                out += ',';
+                detail::append_label(
+                        out, "column",
+                        std::to_string(location ? location->column() : 0));
+                out += "} ";
+                out += std::to_string(metric.count);
+                out += '\n';
+        }
+}
+
+/// @brief
+/// Append a snapshot of metrics in the Prometheus text format to a string.
+///
+/// @details
+/// See ::errors::write_prometheus(std::string &,
+/// const std::vector<error_metric> &).
+///
+/// @param out
+/// The string to append to.
+inline void write_prometheus(std::string &out)
+{
+        write_prometheus(out, snapshot_metrics());
+}
+
+}
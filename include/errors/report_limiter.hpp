@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+#include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/intern.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+namespace detail
+{
+
+/// @cond
+struct alignas(64) report_slot {
+        std::atomic<std::uint64_t> key{ 0 };
+        // NOTE:
+        // The theoretical arrival time of the next report
+        // in nanoseconds, see report_limiter::admit.
+        std::atomic<std::int64_t> next{
+                std::numeric_limits<std::int64_t>::min()
+        };
+        std::atomic<std::uint64_t> suppressed{ 0 };
+        std::atomic<const std::string *> text{ nullptr };
+};
+
+inline std::size_t
+hash_site(std::size_t seed, const std::optional<source_location> &location)
+{
+        // NOTE:
+        // Hash the addresses of the names instead of the strings,
+        // they come from the same literals for the same call site.
+        if (!location) {
+                return hash_combine(seed, 0);
+        }
+        seed = hash_combine(seed, location->line());
+        seed = hash_combine(seed, location->column());
+        seed = hash_combine(seed, reinterpret_cast<std::uintptr_t>(
+                                          location->file_name()));
+        return hash_combine(seed, reinterpret_cast<std::uintptr_t>(
+                                          location->function_name()));
+}
+
+inline std::size_t hash_sites(const error *err)
+{
+        std::size_t seed = 0;
+        for (; err != nullptr; err = err->cause().get()) {
+                // NOTE:
+                // A sampled error has the key of the error type it samples.
+                const auto &type = sampled_type_of(err);
+                seed = hash_combine(seed,
+                                    reinterpret_cast<std::uintptr_t>(&type));
+
+                if (type != typeid(impl::trace_error)) {
+                        seed = hash_site(seed, err->location());
+                        continue;
+                }
+                const auto *trace = cast<impl::trace_error>(err);
+                for (std::size_t i = 0; i < trace->size(); ++i) {
+                        seed = hash_site(seed, trace->frame(i));
+                }
+        }
+        return seed;
+}
+/// @endcond
+
+}
+
+/// @brief
+/// The decision of ::errors::report_limiter::admit.
+struct report_decision {
+        /// @brief
+        /// Whether the error should be reported.
+        bool emit;
+        /// @brief
+        /// The number of errors with the same key
+        /// suppressed since the last one reported,
+        /// always `0` if `emit` is `false`.
+        std::uint64_t suppressed;
+
+        explicit operator bool() const noexcept
+        {
+                return this->emit;
+        }
+};
+
+/// @brief
+/// A limiter which keeps error storms from flooding a log.
+///
+/// @details
+/// Errors are keyed by their chains of call sites:
+/// the dynamic type and the source location of each error,
+/// frames recorded by ::errors::trace included.
+/// Messages are not part of the key,
+/// so errors from the same sites with different messages
+/// share one limit.
+///
+/// Each key has a token bucket
+/// holding up to `burst` reports
+/// and refilled by one report every `interval`,
+/// so the first error of a key is always reported.
+/// Errors over the limit are counted,
+/// the count is reported with the next error of the same key,
+/// or by ::errors::report_limiter::summarize,
+/// which should be called periodically,
+/// for keys which have gone quiet.
+///
+/// This class is thread-safe and lock-free.
+/// Keys live in a fixed open addressing table,
+/// each in its own cache line;
+/// keys found after the table is full share one extra bucket.
+/// Keys are 64-bit hashes,
+/// so two chains colliding share one bucket as well.
+class report_limiter {
+    public:
+        /// @brief
+        /// The clock of the token buckets.
+        using clock = std::chrono::steady_clock;
+
+        /// @brief
+        /// Create a limiter.
+        ///
+        /// @param burst
+        /// The number of errors of a key
+        /// which can be reported at once, at least `1`.
+        ///
+        /// @param interval
+        /// The time to refill one report.
+        ///
+        /// @param capacity
+        /// The number of keys,
+        /// rounded up to a power of two.
+        explicit report_limiter(
+                std::uint32_t burst = 1,
+                std::chrono::nanoseconds interval = std::chrono::seconds(1),
+                std::size_t capacity = 1024)
+                : interval(std::max<std::int64_t>(interval.count(), 1))
+                , tolerance((std::max<std::uint32_t>(burst, 1) - 1) *
+                            this->interval)
+                , mask(round_capacity(capacity) - 1)
+                , slots(std::make_unique<detail::report_slot[]>(this->mask +
+                                                                1))
+        {
+        }
+
+        report_limiter(const report_limiter &) = delete;
+        report_limiter(report_limiter &&) = delete;
+        report_limiter &operator=(const report_limiter &) = delete;
+        report_limiter &operator=(report_limiter &&) = delete;
+
+        ~report_limiter()
+        {
+                for (std::size_t i = 0; i <= this->mask; ++i) {
+                        delete this->slots[i].text.load(
+                                std::memory_order_acquire);
+                }
+                delete this->overflow.text.load(std::memory_order_acquire);
+        }
+
+        /// @brief
+        /// Decide whether an error should be reported.
+        ///
+        /// @param err
+        /// The error chain.
+        ///
+        /// @param now
+        /// The current time.
+        [[nodiscard]]
+        report_decision admit(const error_ptr &err,
+                              clock::time_point now = clock::now()) noexcept
+        {
+                return this->admit(this->find(err.get()), now);
+        }
+
+        /// @brief
+        /// Report an error to a `std::ostream` if it is not over the limit.
+        ///
+        /// @details
+        /// The error is written the same as the default `operator<<`,
+        /// followed by the number of suppressed errors if any
+        /// and a newline, like
+        /// `message (suppressed 42 identical errors)`.
+        ///
+        /// @param os
+        /// The output stream.
+        ///
+        /// @param err
+        /// The error chain, nothing is written for `nullptr`.
+        ///
+        /// @param now
+        /// The current time.
+        ///
+        /// @return
+        /// Whether the error was written.
+        bool report(std::ostream &os, const error_ptr &err,
+                    clock::time_point now = clock::now())
+        {
+                if (!err) {
+                        return false;
+                }
+
+                auto &slot = this->find(err.get());
+                auto decision = this->admit(slot, now);
+                if (!decision) {
+                        return false;
+                }
+
+                if (slot.text.load(std::memory_order_relaxed) == nullptr) {
+                        // NOTE:
+                        // Keep the first error of a key for summaries,
+                        // it is formatted anyway to be reported.
+                        std::string formatted;
+                        format_to(formatted, err);
+                        publish(slot, formatted);
+                        os << formatted;
+                } else {
+                        format_to(std::ostreambuf_iterator<char>(os), err);
+                }
+                if (decision.suppressed != 0) {
+                        os << " (suppressed " << decision.suppressed
+                           << " identical errors)";
+                }
+                os << '\n';
+                return true;
+        }
+
+        /// @brief
+        /// Report the numbers of errors suppressed since last reported.
+        ///
+        /// @details
+        /// The counts are reset.
+        ///
+        /// @param fn
+        /// The function called for each key with suppressed errors,
+        /// with the count and the first error of the key
+        /// formatted by ::errors::format_to,
+        /// which is empty if it has not been reported by
+        /// ::errors::report_limiter::report.
+        ///
+        /// @return
+        /// The total number of suppressed errors.
+        template <typename Fn,
+                  typename = std::enable_if_t<!std::is_base_of_v<
+                          std::ostream, std::remove_reference_t<Fn>>>>
+        std::uint64_t summarize(Fn &&fn)
+        {
+                std::uint64_t total = 0;
+                auto visit = [&total, &fn](detail::report_slot &slot) {
+                        auto count = slot.suppressed.exchange(
+                                0, std::memory_order_relaxed);
+                        if (count == 0) {
+                                return;
+                        }
+                        total += count;
+                        static const std::string none;
+                        const auto *text =
+                                slot.text.load(std::memory_order_acquire);
+                        fn(count, text == nullptr ? none : *text);
+                };
+                for (std::size_t i = 0; i <= this->mask; ++i) {
+                        visit(this->slots[i]);
+                }
+                visit(this->overflow);
+                return total;
+        }
+
+        /// @brief
+        /// Write the numbers of errors suppressed since last reported
+        /// to a `std::ostream`.
+        ///
+        /// @details
+        /// One line for each key,
+        /// like `suppressed 42 identical errors: message`.
+        ///
+        /// @param os
+        /// The output stream.
+        ///
+        /// @return
+        /// The total number of suppressed errors.
+        std::uint64_t summarize(std::ostream &os)
+        {
+                return this->summarize(
+                        [&os](std::uint64_t count, const std::string &text) {
+                                os << "suppressed " << count
+                                   << " identical errors";
+                                if (!text.empty()) {
+                                        os << ": " << text;
+                                }
+                                os << '\n';
+                        });
+        }
+
+    private:
+        static constexpr std::size_t max_probes = 16;
+
+        std::int64_t interval;
+        std::int64_t tolerance;
+        std::size_t mask;
+        std::unique_ptr<detail::report_slot[]> slots;
+        detail::report_slot overflow;
+
+        static std::size_t round_capacity(std::size_t capacity) noexcept
+        {
+                std::size_t result = 1;
+                while (result < capacity) {
+                        result <<= 1;
+                }
+                return result;
+        }
+
+        detail::report_slot &find(const error *err) noexcept
+        {
+                // NOTE:
+                // 0 marks an empty slot.
+                auto key = static_cast<std::uint64_t>(detail::hash_sites(err));
+                key = key == 0 ? 1 : key;
+
+                auto probes = std::min(max_probes, this->mask + 1);
+                for (std::size_t i = 0; i < probes; ++i) {
+                        auto &slot = this->slots[(key + i) & this->mask];
+                        auto current = slot.key.load(std::memory_order_relaxed);
+                        if (current == 0) {
+                                slot.key.compare_exchange_strong(
+                                        current, key,
+                                        std::memory_order_relaxed);
+                                // NOTE:
+                                // On failure,
+                                // current is the key of another thread,
+                                // which might be the same one.
+                                current = current == 0 ? key : current;
+                        }
+                        if (current == key) {
+                                return slot;
+                        }
+                }
+                return this->overflow;
+        }
+
+        report_decision admit(detail::report_slot &slot,
+                              clock::time_point now) noexcept
+        {
+                // NOTE:
+                // A token bucket as the generic cell rate algorithm:
+                // a report is allowed if it does not come earlier
+                // than `tolerance` before the theoretical arrival time,
+                // which then moves forward by `interval`.
+                // It is one compare and swap on one integer.
+                using std::chrono::nanoseconds;
+                auto time = std::chrono::duration_cast<nanoseconds>(
+                                    now.time_since_epoch())
+                                    .count();
+                auto next = slot.next.load(std::memory_order_relaxed);
+                std::int64_t updated = 0;
+                do {
+                        if (next > time + this->tolerance) {
+                                slot.suppressed.fetch_add(
+                                        1, std::memory_order_relaxed);
+                                return { false, 0 };
+                        }
+                        updated = std::max(next, time) + this->interval;
+                } while (!slot.next.compare_exchange_weak(
+                        next, updated, std::memory_order_relaxed));
+
+                return { true, slot.suppressed.exchange(
+                                       0, std::memory_order_relaxed) };
+        }
+
+        static void publish(detail::report_slot &slot,
+                            const std::string &formatted)
+        {
+                auto text = std::make_unique<const std::string>(formatted);
+                const std::string *expected = nullptr;
+                if (slot.text.compare_exchange_strong(
+                            expected, text.get(), std::memory_order_release,
+                            std::memory_order_relaxed)) {
+                        text.release();
+                }
+        }
+};
+
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include "errors/error.hpp"
+#include "errors/error_ptr.hpp"
+#include "errors/memory_resource.hpp"
+#include "errors/source_location.hpp"
+#include "errors/type_id.hpp"
+
+namespace errors
+{
+
+namespace detail
+{
+/// @cond
+class atomic_count {
+    public:
+        void increment() noexcept
+        {
+                this->value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bool decrement() noexcept
+        {
+                return this->value.fetch_sub(1, std::memory_order_acq_rel) ==
+                       1;
+        }
+
+        [[nodiscard]]
+        std::size_t get() const noexcept
+        {
+                return this->value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<std::size_t> value{ 1 };
+};
+
+class plain_count {
+    public:
+        void increment() noexcept
+        {
+                ++this->value;
+        }
+
+        bool decrement() noexcept
+        {
+                return --this->value == 0;
+        }
+
+        [[nodiscard]]
+        std::size_t get() const noexcept
+        {
+                return this->value;
+        }
+
+    private:
+        std::size_t value = 1;
+};
+/// @endcond
+}
+
+template <typename Count>
+class basic_shared_error;
+
+namespace impl
+{
+
+/// @brief
+/// An error referring to an error in a chain
+/// shared by ::errors::basic_shared_error.
+///
+/// @details
+/// It is created when a shared error chain
+/// is converted to ::errors::error_ptr,
+/// for example to be wrapped by ::errors::wrap.
+/// It forwards everything to the referred error
+/// and keeps the shared chain alive.
+///
+/// ::errors::error_ptr::is and ::errors::error_ptr::as
+/// look through it,
+/// so it is never found itself.
+///
+/// Moving the cause out of it
+/// returns another reference to the shared cause.
+template <typename Count>
+class shared_reference_error final : public error {
+    public:
+        /// @brief
+        /// Constructor with a shared error chain and an error in it.
+        ///
+        /// @param chain
+        /// The shared error chain.
+        ///
+        /// @param target
+        /// The error in `chain` to refer to.
+        shared_reference_error(basic_shared_error<Count> chain,
+                               const error *target) noexcept
+                : chain(std::move(chain))
+                , target(target)
+        {
+        }
+
+        const char *what() const noexcept override
+        {
+                return this->target->what();
+        }
+
+        const error_ptr &cause() const & noexcept override
+        {
+                return this->target->cause();
+        }
+
+        error_ptr cause() && noexcept override
+        {
+                const auto *cause = this->target->cause().get();
+                if (cause == nullptr) {
+                        return nullptr;
+                }
+
+                // NOTE:
+                // The shared cause can not be moved,
+                // so refer to it instead.
+                // It falls back to no cause if the reference
+                // can not be allocated, like code_error::what.
+                try {
+                        return detail::allocate<shared_reference_error>(
+                                current_memory_resource(), this->chain,
+                                cause);
+                } catch (...) {
+                        return nullptr;
+                }
+        }
+
+        std::optional<source_location> location() const noexcept override
+        {
+                return this->target->location();
+        }
+
+        const void *cast(type_id id) const noexcept override
+        {
+                if (id == type_id_of<detail::shared_reference_tag>()) {
+                        return this->target;
+                }
+                return this->target->cast(id);
+        }
+
+    private:
+        basic_shared_error<Count> chain;
+        const error *target;
+};
+
+}
+
+/// @brief
+/// A cheap to copy handle to an immutable error chain.
+///
+/// @details
+/// Copying the handle only increases a reference count,
+/// so one error can be delivered to many consumers
+/// without copying or creating the chain again.
+///
+/// It is converted implicitly to ::errors::error_ptr
+/// by creating a small ::errors::impl::shared_reference_error,
+/// so it can be wrapped by ::errors::wrap
+/// and be the cause of any builtin error.
+///
+/// @tparam Count
+/// The reference count,
+/// see ::errors::shared_error and ::errors::local_shared_error.
+template <typename Count>
+class basic_shared_error {
+    public:
+        /// @brief
+        /// Create a handle to no error.
+        basic_shared_error() noexcept = default;
+
+        /// @brief
+        /// Create a handle to no error.
+        basic_shared_error(std::nullptr_t) noexcept
+        {
+        }
+
+        /// @brief
+        /// Share an error chain.
+        ///
+        /// @param err
+        /// The error chain.
+        basic_shared_error(error_ptr &&err)
+                : block(err == nullptr ? nullptr : new block_t{})
+        {
+                if (this->block != nullptr) {
+                        this->block->chain = std::move(err);
+                }
+        }
+
+        basic_shared_error(const basic_shared_error &other) noexcept
+                : block(other.block)
+        {
+                if (this->block != nullptr) {
+                        this->block->count.increment();
+                }
+        }
+
+        basic_shared_error(basic_shared_error &&other) noexcept
+                : block(std::exchange(other.block, nullptr))
+        {
+        }
+
+        basic_shared_error &operator=(const basic_shared_error &other) noexcept
+        {
+                basic_shared_error(other).swap(*this);
+                return *this;
+        }
+
+        basic_shared_error &operator=(basic_shared_error &&other) noexcept
+        {
+                basic_shared_error(std::move(other)).swap(*this);
+                return *this;
+        }
+
+        ~basic_shared_error()
+        {
+                if (this->block != nullptr && this->block->count.decrement()) {
+                        delete this->block;
+                }
+        }
+
+        void swap(basic_shared_error &other) noexcept
+        {
+                std::swap(this->block, other.block);
+        }
+
+        /// @brief
+        /// Get the outermost error of the chain.
+        ///
+        /// @return
+        /// The error, or `nullptr`.
+        [[nodiscard]]
+        const error *get() const noexcept
+        {
+                return this->block == nullptr ? nullptr
+                                              : this->block->chain.get();
+        }
+
+        const error *operator->() const noexcept
+        {
+                return this->get();
+        }
+
+        const error &operator*() const noexcept
+        {
+                return *this->get();
+        }
+
+        /// @brief
+        /// Check if this handle refers to an error.
+        explicit operator bool() const noexcept
+        {
+                return this->block != nullptr;
+        }
+
+        /// @brief
+        /// Get the shared error chain.
+        [[nodiscard]]
+        const error_ptr &chain() const noexcept
+        {
+                static const error_ptr none;
+                return this->block == nullptr ? none : this->block->chain;
+        }
+
+        /// @brief
+        /// Get the number of handles sharing the chain.
+        [[nodiscard]]
+        std::size_t use_count() const noexcept
+        {
+                return this->block == nullptr ? 0 : this->block->count.get();
+        }
+
+        /// @brief
+        /// Refer to the shared chain from an ::errors::error_ptr.
+        ///
+        /// @return
+        /// An ::errors::impl::shared_reference_error
+        /// referring to the outermost error,
+        /// or `nullptr`.
+        operator error_ptr() const
+        {
+                if (this->block == nullptr) {
+                        return nullptr;
+                }
+                return detail::allocate<impl::shared_reference_error<Count>>(
+                        current_memory_resource(), *this, this->get());
+        }
+
+        /// @copydoc ::errors::error_ptr::is
+        template <typename E>
+        [[nodiscard]]
+        bool is() const
+        {
+                return detail::find<E>(this->get()) != nullptr;
+        }
+
+        /// @copydoc ::errors::error_ptr::as() const
+        template <typename E>
+        [[nodiscard]]
+        const E *as() const
+        {
+                return detail::find<E>(this->get());
+        }
+
+        /// @copydoc ::errors::error_ptr::match
+        template <typename... E>
+        [[nodiscard]]
+        std::variant<std::monostate, const E *...> match() const
+        {
+                return detail::match<E...>(this->get(), false,
+                                           std::index_sequence_for<E...>());
+        }
+
+        /// @copydoc ::errors::error_ptr::match_innermost
+        template <typename... E>
+        [[nodiscard]]
+        std::variant<std::monostate, const E *...> match_innermost() const
+        {
+                return detail::match<E...>(this->get(), true,
+                                           std::index_sequence_for<E...>());
+        }
+
+        friend bool operator==(const basic_shared_error &lhs,
+                               std::nullptr_t) noexcept
+        {
+                return !lhs;
+        }
+
+        friend bool operator!=(const basic_shared_error &lhs,
+                               std::nullptr_t) noexcept
+        {
+                return static_cast<bool>(lhs);
+        }
+
+    private:
+        struct block_t {
+                Count count;
+                error_ptr chain;
+        };
+
+        block_t *block = nullptr;
+};
+
+/// @brief
+/// A shared error chain which can be copied between threads.
+using shared_error = basic_shared_error<detail::atomic_count>;
+
+/// @brief
+/// A shared error chain whose handles are only used by one thread.
+///
+/// @details
+/// The reference count is not atomic,
+/// which makes copying cheaper.
+using local_shared_error = basic_shared_error<detail::plain_count>;
+
+}
+
+#if not defined(ERRORS_DISABLE_OSTREAM)
+
+#include <ostream>
+
+template <typename Count>
+std::ostream &operator<<(std::ostream &os,
+                         const errors::basic_shared_error<Count> &err)
+{
+        return os << err.chain();
+}
+#endif
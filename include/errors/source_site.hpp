@@ -0,0 +1,335 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <optional>
+
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+namespace detail
+{
+
+/// @brief
+/// The process wide table of interned source locations.
+///
+/// @details
+/// It is an open addressing hash table of fixed size.
+/// Each slot is claimed by a compare-and-swap
+/// and never changes after it is published,
+/// so both interning and looking up are lock-free.
+/// The table lives in zero-initialized static storage,
+/// only the pages of used slots are touched.
+///
+/// A source location is identified by its line, column
+/// and the contents of its file name and function name,
+/// so the same call site seen from different translation units
+/// is interned only once.
+class site_table {
+    public:
+        /// @brief
+        /// The number of slots of the table.
+        static constexpr std::uint32_t capacity = 1U << 14;
+
+        /// @brief
+        /// Intern a source location.
+        ///
+        /// @param location
+        /// The source location.
+        ///
+        /// @return
+        /// The identity of the source location, starting from `1`,
+        /// or `0` if the table is full.
+        [[nodiscard]]
+        static std::uint32_t intern(const source_location &location) noexcept
+        {
+                auto &cached = cache_slot(location);
+                if (cached.id != 0 && cached.file == location.file_name() &&
+                    cached.function == location.function_name() &&
+                    cached.line == location.line() &&
+                    cached.column == location.column()) {
+                        return cached.id;
+                }
+
+                auto id = instance().insert(location);
+                if (id != 0) {
+                        cached = { location.file_name(),
+                                   location.function_name(),
+                                   location.line(), location.column(), id };
+                }
+                return id;
+        }
+
+        /// @brief
+        /// Get an interned source location.
+        ///
+        /// @param id
+        /// The identity returned by ::errors::detail::site_table::intern.
+        ///
+        /// @return
+        /// The source location,
+        /// or `std::nullopt` if `id` is not valid.
+        [[nodiscard]]
+        static std::optional<source_location> find(std::uint32_t id) noexcept
+        {
+                if (id == 0 || id > capacity) {
+                        return std::nullopt;
+                }
+
+                const auto &slot = instance().slots[id - 1];
+                if (slot.state.load(std::memory_order_acquire) != ready) {
+                        return std::nullopt;
+                }
+                return slot.location();
+        }
+
+    private:
+        enum : std::uint32_t { empty = 0, writing = 1, ready = 2 };
+
+        struct slot_t {
+                std::atomic<std::uint32_t> state;
+                alignas(source_location) unsigned char
+                        storage[sizeof(source_location)];
+
+                [[nodiscard]]
+                const source_location &location() const noexcept
+                {
+                        return *std::launder(
+                                reinterpret_cast<const source_location *>(
+                                        this->storage));
+                }
+        };
+
+        struct cache_entry_t {
+                const char *file;
+                const char *function;
+                std::uint_least32_t line;
+                std::uint_least32_t column;
+                std::uint32_t id;
+        };
+
+        static site_table &instance() noexcept
+        {
+                // NOTE:
+                // The table has a trivial default constructor,
+                // so it is zero-initialized before any dynamic initialization
+                // and no guard is needed.
+                static site_table table;
+                return table;
+        }
+
+        static cache_entry_t &cache_slot(const source_location &location)
+        {
+                constexpr std::size_t size = 64;
+                thread_local cache_entry_t cache[size] = {};
+
+                auto key = reinterpret_cast<std::uintptr_t>(
+                                   location.function_name()) ^
+                           (static_cast<std::uintptr_t>(location.line())
+                            << 8) ^
+                           static_cast<std::uintptr_t>(location.column());
+                return cache[(key ^ (key >> 6)) % size];
+        }
+
+        static std::uint64_t hash(const char *str, std::uint64_t seed) noexcept
+        {
+                // FNV-1a
+                auto result = seed;
+                for (; *str != '\0'; ++str) {
+                        result ^= static_cast<unsigned char>(*str);
+                        result *= 0x100000001b3ULL;
+                }
+                return result;
+        }
+
+        static std::uint64_t hash(const source_location &location) noexcept
+        {
+                auto result = 0xcbf29ce484222325ULL;
+                result = hash(location.file_name(), result);
+                result = hash(location.function_name(), result);
+                result ^= location.line();
+                result *= 0x100000001b3ULL;
+                result ^= location.column();
+                result *= 0x100000001b3ULL;
+                return result;
+        }
+
+        static bool equal(const char *lhs, const char *rhs) noexcept
+        {
+                return lhs == rhs || std::strcmp(lhs, rhs) == 0;
+        }
+
+        static bool equal(const source_location &lhs,
+                          const source_location &rhs) noexcept
+        {
+                return lhs.line() == rhs.line() &&
+                       lhs.column() == rhs.column() &&
+                       equal(lhs.file_name(), rhs.file_name()) &&
+                       equal(lhs.function_name(), rhs.function_name());
+        }
+
+        std::uint32_t insert(const source_location &location) noexcept
+        {
+                const auto start = hash(location);
+                for (std::uint32_t probe = 0; probe < capacity; ++probe) {
+                        const auto index = static_cast<std::uint32_t>(
+                                (start + probe) & (capacity - 1));
+                        auto &slot = this->slots[index];
+
+                        auto state = slot.state.load(std::memory_order_acquire);
+                        if (state == empty &&
+                            slot.state.compare_exchange_strong(
+                                    state, writing,
+                                    std::memory_order_acquire)) {
+                                new (slot.storage) source_location(location);
+                                slot.state.store(ready,
+                                                 std::memory_order_release);
+                                return index + 1;
+                        }
+
+                        while (state == writing) {
+                                state = slot.state.load(
+                                        std::memory_order_acquire);
+                        }
+
+                        if (equal(slot.location(), location)) {
+                                return index + 1;
+                        }
+                }
+                return 0;
+        }
+
+        slot_t slots[capacity];
+};
+
+}
+
+/// @brief
+/// A source location interned into a 32-bit identity.
+///
+/// @details
+/// Interning a source location for the first time
+/// copies it into a process wide lock-free table,
+/// later interning of the same call site is a lookup
+/// in a small cache of current thread.
+///
+/// Sites are cheap to store, compare, hash and serialize,
+/// and errors can be grouped by call site
+/// without comparing strings.
+///
+/// The identity is only meaningful inside current process.
+/// When the table is full,
+/// new source locations are interned to the unknown site,
+/// whose identity is `0`.
+///
+/// Define `ERRORS_COMPACT_SOURCE_LOCATION`
+/// before including any header files from `errors`
+/// to make builtin errors store a site
+/// instead of a whole ::errors::source_location,
+/// which makes each of them and each frame recorded by ::errors::trace
+/// smaller.
+/// The first error created at a call site
+/// pays for interning its source location.
+///
+/// @warning
+/// `ERRORS_COMPACT_SOURCE_LOCATION` changes the layout of builtin errors,
+/// so it **MUST** be defined the same way
+/// in all translation units of a program.
+class source_site {
+    public:
+        /// @brief
+        /// Create the unknown site.
+        constexpr source_site() noexcept = default;
+
+        /// @brief
+        /// Intern a source location.
+        ///
+        /// @param location
+        /// The source location.
+        explicit source_site(const source_location &location) noexcept
+                : id_(detail::site_table::intern(location))
+        {
+        }
+
+        /// @brief
+        /// Get the identity of this site.
+        [[nodiscard]]
+        constexpr std::uint32_t id() const noexcept
+        {
+                return this->id_;
+        }
+
+        /// @brief
+        /// Get the source location of this site.
+        ///
+        /// @return
+        /// The source location,
+        /// or `std::nullopt` for the unknown site.
+        [[nodiscard]]
+        std::optional<source_location> location() const noexcept
+        {
+                return detail::site_table::find(this->id_);
+        }
+
+        friend constexpr bool operator==(source_site lhs,
+                                         source_site rhs) noexcept
+        {
+                return lhs.id_ == rhs.id_;
+        }
+
+        friend constexpr bool operator!=(source_site lhs,
+                                         source_site rhs) noexcept
+        {
+                return lhs.id_ != rhs.id_;
+        }
+
+        friend constexpr bool operator<(source_site lhs,
+                                        source_site rhs) noexcept
+        {
+                return lhs.id_ < rhs.id_;
+        }
+
+    private:
+        std::uint32_t id_ = 0;
+};
+
+namespace detail
+{
+/// @cond
+#if defined(ERRORS_COMPACT_SOURCE_LOCATION)
+using stored_location = source_site;
+#else
+using stored_location = source_location;
+#endif
+
+inline std::optional<source_location>
+load_location(const source_location &location) noexcept
+{
+        return location;
+}
+
+inline std::optional<source_location>
+load_location(const source_site &site) noexcept
+{
+        return site.location();
+}
+/// @endcond
+}
+
+}
+
+namespace std
+{
+template <>
+struct hash< ::errors::source_site> {
+        std::size_t operator()(::errors::source_site site) const noexcept
+        {
+                return std::hash<std::uint32_t>()(site.id());
+        }
+};
+}
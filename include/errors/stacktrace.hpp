@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "errors/error_ptr.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/stacktrace.hpp"
+#include "errors/memory_resource.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+
+namespace detail
+{
+/// @cond
+template <typename E>
+inline std::atomic<std::uint32_t> stacktrace_rate{ 0 };
+
+template <typename E>
+inline thread_local std::uint32_t stacktrace_countdown = 0;
+
+inline std::size_t capture_stack(void **frames, std::size_t size) noexcept
+{
+#if defined(ERRORS_HAS_EXECINFO)
+        return static_cast<std::size_t>(
+                backtrace(frames, static_cast<int>(size)));
+#else
+        static_cast<void>(frames);
+        static_cast<void>(size);
+        return 0;
+#endif
+}
+
+template <typename E>
+bool sample_stacktrace() noexcept
+{
+        auto rate = stacktrace_rate<E>.load(std::memory_order_relaxed);
+        if (rate == 0) {
+                return false;
+        }
+
+        auto &countdown = stacktrace_countdown<E>;
+        if (countdown == 0 || countdown > rate) {
+                countdown = rate;
+        }
+        return --countdown == 0;
+}
+
+template <typename E, typename... Args>
+[[gnu::noinline]] error_ptr make_sampled(Args &&...args)
+{
+        // NOTE:
+        // Skip the frame of this function.
+        void *frames[impl::stacktrace::capacity + 1];
+        auto size = capture_stack(frames, sizeof(frames) / sizeof(frames[0]));
+        auto skipped = size == 0 ? 0 : 1;
+
+        return allocate<impl::sampled_error<E>>(
+                current_memory_resource(), frames + skipped, size - skipped,
+                std::forward<Args>(args)...);
+}
+/// @endcond
+}
+
+/// @brief
+/// Record stack traces of errors created by ::errors::make::with.
+///
+/// @details
+/// A sampled error is created as an ::errors::impl::sampled_error of `E`,
+/// which records the raw return addresses of the stack
+/// and turns them into symbols only when it is printed.
+/// It is still an `E` and the outermost error,
+/// so sampling does not change how the chain is read.
+///
+/// Errors are sampled per type and per thread:
+/// with `one_in` set to `N`,
+/// every `N`th error of type `E` created by a thread is sampled.
+/// Types derived from `E` are sampled by their own rates,
+/// and final types are never sampled.
+/// It can be changed at any time from any thread.
+///
+/// @tparam E
+/// The error type passed to ::errors::make.
+///
+/// @param one_in
+/// `1` to sample all errors, `0` to sample none, which is the default.
+template <typename E>
+void sample_stacktraces(std::uint32_t one_in) noexcept
+{
+        if (one_in != 0) {
+                // NOTE:
+                // The first call of backtrace loads the unwinder,
+                // do it now instead of when an error is created.
+                void *frame = nullptr;
+                detail::capture_stack(&frame, 1);
+        }
+        detail::stacktrace_rate<E>.store(one_in, std::memory_order_relaxed);
+}
+
+/// @brief
+/// Get the stack trace recorded by ::errors::sample_stacktraces.
+///
+/// @param err
+/// The error chain.
+///
+/// @return
+/// The stack trace of the outermost sampled error of the chain,
+/// or `nullptr` if no error of the chain is sampled.
+inline const impl::stacktrace *stacktrace_of(const error_ptr &err) noexcept
+{
+        for (const auto *current = err.get(); current != nullptr;
+             current = current->cause().get()) {
+                const auto *stack = detail::stacktrace_of(current);
+                if (stack != nullptr) {
+                        return stack;
+                }
+        }
+        return nullptr;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <typeinfo>
+
+#include "errors/error_ptr.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/make.hpp"
+#include "errors/source_location.hpp"
+
+namespace errors
+{
+namespace detail
+{
+/// @cond
+inline error_ptr trace(error_ptr &&cause, source_location location)
+{
+        if (cause == nullptr) {
+                return nullptr;
+        }
+
+        // NOTE:
+        // Only the outermost error is owned by us and safe to modify.
+        // A trace_error found through a reference, such as
+        // ::errors::shared_error, is shared and must not be modified.
+        if (typeid(*cause) == typeid(impl::trace_error) &&
+            const_cast<impl::trace_error *>(
+                    detail::cast<impl::trace_error>(cause.get()))
+                    ->push(std::move(location))) {
+                return std::move(cause);
+        }
+
+        return detail::make<impl::trace_error>::with(std::move(cause),
+                                                     std::move(location));
+}
+/// @endcond
+}
+
+/// @brief
+/// A function like class to record the source location
+/// an error is passed through.
+///
+/// @details
+/// It works like ::errors::wrap without a message,
+/// but consecutive calls record their source locations
+/// into one ::errors::impl::trace_error,
+/// so only one allocation is needed
+/// every ::errors::impl::trace_error::capacity calls.
+///
+/// ```cpp
+/// error_ptr fn()
+/// {
+///         auto err = fn2();
+///         if (err) {
+///                 return errors::trace(std::move(err));
+///         }
+///         return nullptr;
+/// }
+/// ```
+///
+/// @note
+/// Code walking the chain by `cause()`
+/// sees one error for all these frames,
+/// use ::errors::impl::trace_error::frame to get each of them.
+class trace : public error_ptr {
+    public:
+        /// @brief
+        /// Record the source location of the caller on an error.
+        ///
+        /// @param cause
+        /// The error.
+        ///
+        /// @param location
+        /// The source location.
+        trace(error_ptr &&cause,
+              source_location location = source_location::current())
+                : error_ptr(detail::trace(std::move(cause),
+                                          std::move(location)))
+        {
+        }
+};
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <type_traits>
+
+namespace errors
+{
+
+/// @brief
+/// Identity of an error type registered by ::ERRORS_REGISTER_TYPE.
+using type_id = const void *;
+
+namespace detail
+{
+/// @cond
+template <typename E>
+struct type_tag {
+        static constexpr char id = 0;
+};
+
+template <typename T, typename...>
+struct first {
+        using type = T;
+};
+
+template <typename... T>
+using first_t = typename first<T...>::type;
+
+template <typename E, typename = void>
+struct is_registered : std::false_type {};
+
+template <typename E>
+struct is_registered<E, std::void_t<typename E::errors_registered_type>>
+        : std::is_same<typename E::errors_registered_type, E> {};
+
+// NOTE:
+// Each registered type declares a hidden friend
+// `errors_registered_nearest`,
+// which argument dependent lookup finds for the type and its bases.
+// Excluding the type itself,
+// overload resolution picks the most derived registered base,
+// or fails if there is none or more than one.
+template <typename E>
+struct registered_probe {};
+
+template <typename E>
+struct not_self {
+        template <typename X,
+                  std::enable_if_t<!std::is_same_v<E, X>, int> = 0>
+        constexpr not_self(registered_probe<X>) noexcept
+        {
+        }
+};
+
+template <typename T, typename = void>
+struct nearest_registered {
+        using type = void;
+};
+
+template <typename T>
+struct nearest_registered<
+        T, std::void_t<decltype(errors_registered_nearest(
+                   static_cast<T *>(nullptr), registered_probe<T>()))>> {
+        using type = std::remove_pointer_t<decltype(errors_registered_nearest(
+                static_cast<T *>(nullptr), registered_probe<T>()))>;
+};
+
+template <typename T, typename... Bases>
+constexpr bool lists_registered_bases() noexcept
+{
+        using nearest = typename nearest_registered<T>::type;
+        if constexpr (std::is_void_v<nearest>) {
+                // NOTE:
+                // No registered base, or several unrelated ones,
+                // which cannot be told apart here,
+                // so only a single listed base is known to be wrong.
+                return sizeof...(Bases) != 1;
+        } else {
+                return (std::is_same_v<nearest, Bases> || ...);
+        }
+}
+
+template <typename T, typename... Bases>
+const void *cast_registered(const T *self, type_id id) noexcept
+{
+        static_assert(((std::is_base_of_v<Bases, T> &&
+                        is_registered<Bases>::value) &&
+                       ...),
+                      "bases of ERRORS_REGISTER_TYPE must be registered "
+                      "bases of the type");
+        static_assert(lists_registered_bases<T, Bases...>(),
+                      "ERRORS_REGISTER_TYPE must list all registered "
+                      "direct bases of the type");
+
+        if (id == &type_tag<T>::id) {
+                return self;
+        }
+
+        const void *result = nullptr;
+        // NOTE:
+        // Call the overrider of each base non-virtually,
+        // so `self` is adjusted to the right subobject.
+        ((result = result != nullptr ? result : self->Bases::cast(id)), ...);
+        return result;
+}
+/// @endcond
+}
+
+/// @brief
+/// Get the identity of an error type.
+///
+/// @tparam E
+/// The error type.
+template <typename E>
+[[nodiscard]]
+constexpr type_id type_id_of() noexcept
+{
+        return &detail::type_tag<E>::id;
+}
+
+/// @brief
+/// Check if an error type is registered by ::ERRORS_REGISTER_TYPE.
+///
+/// @details
+/// A type derived from a registered type
+/// without registering itself is not registered.
+template <typename E>
+constexpr bool is_registered_v = detail::is_registered<E>::value;
+
+}
+
+/// @brief
+/// Register an error type for fast type checking.
+///
+/// @details
+/// Use this macro in the class body of an error type like this:
+///
+/// ```cpp
+/// class my_error : public errors::impl::runtime_error {
+///         ERRORS_REGISTER_TYPE(my_error, errors::impl::runtime_error);
+///
+///     public:
+///         // ...
+/// };
+/// ```
+///
+/// The first argument is the type itself,
+/// the rest arguments are its direct bases
+/// which are registered as well, if any.
+/// Leaving out a registered base fails to compile,
+/// as `is` and `as` would not find it.
+///
+/// `errors::error_ptr::is` and `errors::error_ptr::as`
+/// check a registered type
+/// by comparing a few pointers on each error of the chain
+/// instead of calling `dynamic_cast`.
+/// Types which are not registered still work with `dynamic_cast`.
+///
+/// @note
+/// This macro leaves the access specifier as `public`.
+#define ERRORS_REGISTER_TYPE(...)                                            \
+    public:                                                                  \
+        [[nodiscard]]                                                        \
+        const void *cast(::errors::type_id id) const noexcept override      \
+        {                                                                    \
+                return ::errors::detail::cast_registered<__VA_ARGS__>(this, \
+                                                                      id);  \
+        }                                                                    \
+        friend constexpr ::errors::detail::first_t<__VA_ARGS__>              \
+                *errors_registered_nearest(                                  \
+                        ::errors::detail::first_t<__VA_ARGS__> *self,        \
+                        ::errors::detail::not_self<                          \
+                                ::errors::detail::first_t<__VA_ARGS__>>)     \
+                        noexcept                                             \
+        {                                                                    \
+                return self;                                                 \
+        }                                                                    \
+        using errors_registered_type = ::errors::detail::first_t<__VA_ARGS__>
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <utility>
+#include <variant>
+
 #include "errors/error.hpp"
 #include "errors/error_ptr.hpp"
 
@@ -10,31 +13,22 @@ template <typename E>
 [[nodiscard]]
 bool is(const error &err) noexcept
 {
-        auto current = &err;
-        while (current != nullptr) {
-                if (dynamic_cast<const E *>(current) != nullptr) {
-                        return true;
-                }
-
-                current = current->cause().get();
-        }
-        return false;
+        return detail::find<E>(&err) != nullptr;
 }
 
 template <typename E>
 [[nodiscard]]
 const E *as(const error &err) noexcept
 {
-        auto current = &err;
-        while (current != nullptr) {
-                auto result = dynamic_cast<const E *>(current);
-                if (result != nullptr) {
-                        return result;
-                }
+        return detail::find<E>(&err);
+}
 
-                current = current->cause().get();
-        }
-        return nullptr;
+template <typename... E>
+[[nodiscard]]
+std::variant<std::monostate, const E *...> match(const error &err) noexcept
+{
+        return detail::match<E...>(&err, false,
+                                   std::index_sequence_for<E...>());
 }
 
 }
@@ -0,0 +1,690 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "errors/error_ptr.hpp"
+#include "errors/impl/code_error.hpp"
+#include "errors/impl/runtime_error.hpp"
+#include "errors/impl/sampled_error.hpp"
+#include "errors/impl/system_error.hpp"
+#include "errors/impl/trace_error.hpp"
+#include "errors/impl/wrap_error.hpp"
+#include "errors/make.hpp"
+#include "errors/source_location.hpp"
+#include "errors/trace.hpp"
+
+namespace errors
+{
+
+/// @brief
+/// The kind of an error in the binary format.
+enum class wire_tag : std::uint8_t {
+        /// @brief
+        /// Any other error, only its `what` is kept.
+        other = 0,
+        /// @brief
+        /// An ::errors::impl::runtime_error.
+        runtime = 1,
+        /// @brief
+        /// An ::errors::impl::wrap_error.
+        wrap = 2,
+        /// @brief
+        /// An ::errors::impl::code_error<int>,
+        /// its message is kept without the code.
+        code = 3,
+        /// @brief
+        /// An ::errors::impl::system_error,
+        /// its message is kept without the code.
+        system = 4,
+        /// @brief
+        /// A frame recorded by ::errors::trace, without message.
+        trace = 5,
+};
+
+/// @brief
+/// A read-only view of an error in a buffer
+/// written by ::errors::write_binary.
+///
+/// @details
+/// The strings point into the buffer,
+/// which **MUST** outlive the view.
+/// They are not null-terminated.
+struct wire_record {
+        /// @brief
+        /// The kind of the error.
+        wire_tag tag;
+        /// @brief
+        /// Whether the error has a code.
+        bool has_code;
+        /// @brief
+        /// Whether the error has a source location.
+        bool has_location;
+        /// @brief
+        /// The code, `0` if there is none.
+        int code;
+        /// @brief
+        /// The line of the source location.
+        std::uint32_t line;
+        /// @brief
+        /// The column of the source location.
+        std::uint32_t column;
+        /// @brief
+        /// The file name of the source location.
+        std::string_view file_name;
+        /// @brief
+        /// The function name of the source location.
+        std::string_view function_name;
+        /// @brief
+        /// The message.
+        std::string_view message;
+};
+
+namespace detail
+{
+
+/// @cond
+// NOTE:
+// A chain is a magic byte, a version byte,
+// the number of records as a varint
+// and the records from the outermost error to the innermost one.
+// A record is its tag, a byte of flags,
+// the code as a zigzag varint if it has one,
+// the line, the column, the file name and the function name
+// if it has a source location,
+// and the message.
+// Strings are their lengths as varints followed by their bytes.
+constexpr unsigned char wire_magic = 0xE7;
+constexpr unsigned char wire_version = 1;
+constexpr unsigned char wire_has_code = 1U << 0;
+constexpr unsigned char wire_has_location = 1U << 1;
+
+inline void put_varint(std::string &out, std::uint64_t value)
+{
+        while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+}
+
+inline void put_bytes(std::string &out, std::string_view str)
+{
+        put_varint(out, str.size());
+        out.append(str.data(), str.size());
+}
+
+inline std::uint64_t zigzag(int value) noexcept
+{
+        auto wide = static_cast<std::int64_t>(value);
+        return (static_cast<std::uint64_t>(wide) << 1) ^
+               static_cast<std::uint64_t>(wide >> 63);
+}
+
+inline int unzigzag(std::uint64_t value) noexcept
+{
+        return static_cast<int>(static_cast<std::int64_t>(value >> 1) ^
+                                -static_cast<std::int64_t>(value & 1));
+}
+
+inline void put_location(std::string &out, const source_location &location)
+{
+        put_varint(out, location.line());
+        put_varint(out, location.column());
+        put_bytes(out, location.file_name());
+        put_bytes(out, location.function_name());
+}
+
+inline void put_record(std::string &out, wire_tag tag,
+                       const std::optional<int> &code,
+                       const std::optional<source_location> &location,
+                       std::string_view message)
+{
+        unsigned char flags = 0;
+        flags |= code ? wire_has_code : 0;
+        flags |= location ? wire_has_location : 0;
+        out.push_back(static_cast<char>(tag));
+        out.push_back(static_cast<char>(flags));
+        if (code) {
+                put_varint(out, zigzag(code.value()));
+        }
+        if (location) {
+                put_location(out, location.value());
+        }
+        put_bytes(out, message);
+}
+
+inline wire_tag wire_tag_of(const error *err) noexcept
+{
+        const auto &type = sampled_type_of(err);
+        if (type == typeid(impl::wrap_error)) {
+                return wire_tag::wrap;
+        }
+        if (type == typeid(impl::runtime_error)) {
+                return wire_tag::runtime;
+        }
+        if (type == typeid(impl::system_error)) {
+                return wire_tag::system;
+        }
+        if (type == typeid(impl::code_error<int>)) {
+                return wire_tag::code;
+        }
+        if (type == typeid(impl::trace_error)) {
+                return wire_tag::trace;
+        }
+        return wire_tag::other;
+}
+
+class wire_reader {
+    public:
+        explicit wire_reader(std::string_view data) noexcept
+                : data(data)
+        {
+        }
+
+        [[nodiscard]]
+        std::size_t offset() const noexcept
+        {
+                return this->position;
+        }
+
+        bool byte(unsigned char &value) noexcept
+        {
+                if (this->position >= this->data.size()) {
+                        return false;
+                }
+                value = static_cast<unsigned char>(
+                        this->data[this->position++]);
+                return true;
+        }
+
+        bool varint(std::uint64_t &value) noexcept
+        {
+                value = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7) {
+                        unsigned char c = 0;
+                        if (!this->byte(c)) {
+                                return false;
+                        }
+                        value |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+                        if ((c & 0x80) == 0) {
+                                return true;
+                        }
+                }
+                return false;
+        }
+
+        bool u32(std::uint32_t &value) noexcept
+        {
+                std::uint64_t wide = 0;
+                if (!this->varint(wide) || wide > UINT32_MAX) {
+                        return false;
+                }
+                value = static_cast<std::uint32_t>(wide);
+                return true;
+        }
+
+        bool bytes(std::string_view &value) noexcept
+        {
+                std::uint64_t size = 0;
+                if (!this->varint(size) ||
+                    size > this->data.size() - this->position) {
+                        return false;
+                }
+                value = this->data.substr(this->position,
+                                          static_cast<std::size_t>(size));
+                this->position += static_cast<std::size_t>(size);
+                return true;
+        }
+
+        bool record(wire_record &value) noexcept
+        {
+                unsigned char tag = 0;
+                unsigned char flags = 0;
+                if (!this->byte(tag) || tag > 5 || !this->byte(flags) ||
+                    (flags & ~(wire_has_code | wire_has_location)) != 0) {
+                        return false;
+                }
+
+                value = {};
+                value.tag = static_cast<wire_tag>(tag);
+                value.has_code = (flags & wire_has_code) != 0;
+                value.has_location = (flags & wire_has_location) != 0;
+
+                std::uint64_t code = 0;
+                if (value.has_code) {
+                        if (!this->varint(code) || code > UINT32_MAX) {
+                                return false;
+                        }
+                        value.code = unzigzag(code);
+                }
+                if (value.has_location &&
+                    (!this->u32(value.line) || !this->u32(value.column) ||
+                     !this->bytes(value.file_name) ||
+                     !this->bytes(value.function_name))) {
+                        return false;
+                }
+                return this->bytes(value.message);
+        }
+
+    private:
+        std::string_view data;
+        std::size_t position = 0;
+};
+
+class wire_strings {
+    public:
+        static constexpr std::size_t default_capacity = 1 << 20;
+
+        explicit wire_strings(std::size_t capacity) noexcept
+                : capacity(capacity)
+        {
+        }
+
+        // NOTE:
+        // Names of received source locations are kept for the whole process,
+        // like ::errors::detail::site_table,
+        // as decoded errors point to them.
+        // The table is bounded,
+        // so a peer sending distinct names can not grow it forever.
+        static wire_strings &instance()
+        {
+                static auto *strings = new wire_strings(default_capacity);
+                return *strings;
+        }
+
+        // NOTE:
+        // Return nullptr if the table is full.
+        const char *intern(std::string_view str)
+        {
+                std::string key(str);
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto found = this->set.find(key);
+                if (found != this->set.end()) {
+                        return found->c_str();
+                }
+                if (key.size() + 1 > this->capacity - this->used) {
+                        return nullptr;
+                }
+                this->used += key.size() + 1;
+                return this->set.insert(std::move(key)).first->c_str();
+        }
+
+    private:
+        std::mutex mutex;
+        std::unordered_set<std::string> set;
+        std::size_t capacity;
+        std::size_t used = 0;
+};
+/// @endcond
+
+}
+
+/// @brief
+/// Append an error chain in a compact binary format to a string.
+///
+/// @details
+/// Each error is one record with its kind, its code,
+/// its source location and its message,
+/// from the outermost error to the innermost one.
+/// Frames recorded by ::errors::trace are expanded,
+/// stack traces recorded by ::errors::sample_stacktraces are not written,
+/// and errors of other types only keep their `what`.
+///
+/// Read it back with ::errors::wire_chain::parse.
+///
+/// @param out
+/// The string to append to.
+///
+/// @param err
+/// The error chain, a null error is a chain of no record.
+inline void write_binary(std::string &out, const error_ptr &err)
+{
+        std::size_t count = 0;
+        for (const auto *current = err.get(); current != nullptr;
+             current = current->cause().get()) {
+                const auto *trace = detail::cast<impl::trace_error>(current);
+                count += trace == nullptr ? 1 : trace->size();
+        }
+
+        out.push_back(static_cast<char>(detail::wire_magic));
+        out.push_back(static_cast<char>(detail::wire_version));
+        detail::put_varint(out, count);
+
+        for (const auto *current = err.get(); current != nullptr;
+             current = current->cause().get()) {
+                auto tag = detail::wire_tag_of(current);
+                if (tag == wire_tag::other) {
+                        // NOTE:
+                        // Look through references of ::errors::shared_error.
+                        tag = detail::wire_tag_of(
+                                detail::referenced_of(current));
+                }
+
+                switch (tag) {
+                case wire_tag::trace: {
+                        const auto *trace =
+                                detail::cast<impl::trace_error>(current);
+                        for (std::size_t i = 0; i < trace->size(); ++i) {
+                                detail::put_record(out, tag, std::nullopt,
+                                                   trace->frame(i), "");
+                        }
+                        continue;
+                }
+                case wire_tag::code:
+                case wire_tag::system: {
+                        const auto *coded =
+                                detail::cast<impl::code_error<int>>(current);
+                        detail::put_record(out, tag, coded->code,
+                                           current->location(),
+                                           coded->message.view());
+                        continue;
+                }
+                default:
+                        break;
+                }
+
+                detail::put_record(out, tag, std::nullopt,
+                                   current->location(),
+                                   current->what());
+        }
+}
+
+/// @brief
+/// A read-only view of an error chain
+/// written by ::errors::write_binary.
+///
+/// @details
+/// It is checked once by ::errors::wire_chain::parse,
+/// then iterating it decodes ::errors::wire_record
+/// from the outermost error to the innermost one
+/// without allocating.
+/// The buffer **MUST** outlive the view.
+class wire_chain {
+    public:
+        /// @brief
+        /// An iterator of ::errors::wire_record.
+        class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = wire_record;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const wire_record *;
+                using reference = const wire_record &;
+
+                iterator() noexcept = default;
+
+                reference operator*() const noexcept
+                {
+                        return this->current;
+                }
+
+                pointer operator->() const noexcept
+                {
+                        return &this->current;
+                }
+
+                iterator &operator++() noexcept
+                {
+                        --this->remaining;
+                        if (this->remaining != 0) {
+                                // NOTE:
+                                // The whole chain has been checked.
+                                this->reader.record(this->current);
+                        }
+                        return *this;
+                }
+
+                iterator operator++(int) noexcept
+                {
+                        auto result = *this;
+                        ++*this;
+                        return result;
+                }
+
+                friend bool operator==(const iterator &lhs,
+                                       const iterator &rhs) noexcept
+                {
+                        return lhs.remaining == rhs.remaining;
+                }
+
+                friend bool operator!=(const iterator &lhs,
+                                       const iterator &rhs) noexcept
+                {
+                        return !(lhs == rhs);
+                }
+
+            private:
+                friend class wire_chain;
+
+                iterator(std::string_view records, std::size_t count) noexcept
+                        : reader(records)
+                        , remaining(count)
+                {
+                        if (this->remaining != 0) {
+                                this->reader.record(this->current);
+                        }
+                }
+
+                detail::wire_reader reader{ std::string_view() };
+                wire_record current{};
+                std::size_t remaining = 0;
+        };
+
+        /// @brief
+        /// The default maximum number of records
+        /// accepted by ::errors::wire_chain::parse
+        /// and decoded by ::errors::wire_chain::to_error.
+        ///
+        /// @details
+        /// Destroying an error chain recurses once for each error,
+        /// so a chain from an untrusted peer has to be bounded.
+        static constexpr std::size_t default_max_depth = 1024;
+
+        /// @brief
+        /// Check a buffer and create a view of it.
+        ///
+        /// @param data
+        /// The buffer, which might have more data after the chain.
+        ///
+        /// @param max_depth
+        /// The maximum number of records.
+        ///
+        /// @return
+        /// The view, or `std::nullopt` if the buffer is malformed
+        /// or has more than `max_depth` records.
+        [[nodiscard]]
+        static std::optional<wire_chain>
+        parse(std::string_view data,
+              std::size_t max_depth = default_max_depth) noexcept
+        {
+                detail::wire_reader reader(data);
+                unsigned char magic = 0;
+                unsigned char version = 0;
+                std::uint64_t count = 0;
+                if (!reader.byte(magic) || magic != detail::wire_magic ||
+                    !reader.byte(version) || version != detail::wire_version ||
+                    !reader.varint(count) || count > data.size() ||
+                    count > max_depth) {
+                        return std::nullopt;
+                }
+
+                auto start = reader.offset();
+                wire_record record{};
+                for (std::uint64_t i = 0; i < count; ++i) {
+                        if (!reader.record(record)) {
+                                return std::nullopt;
+                        }
+                }
+                return wire_chain(
+                        data.substr(start, reader.offset() - start),
+                        static_cast<std::size_t>(count),
+                        reader.offset());
+        }
+
+        /// @brief
+        /// Get the number of records.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+                return this->count;
+        }
+
+        /// @brief
+        /// Check if the chain is a null error.
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+                return this->count == 0;
+        }
+
+        /// @brief
+        /// Get the number of bytes of the buffer used by the chain.
+        [[nodiscard]]
+        std::size_t encoded_size() const noexcept
+        {
+                return this->used;
+        }
+
+        [[nodiscard]]
+        iterator begin() const noexcept
+        {
+                return iterator(this->records, this->count);
+        }
+
+        [[nodiscard]]
+        iterator end() const noexcept
+        {
+                return iterator();
+        }
+
+        /// @brief
+        /// Create errors from the records.
+        ///
+        /// @details
+        /// Records of ::errors::wire_tag::trace become frames of
+        /// ::errors::trace,
+        /// the innermost record becomes
+        /// an ::errors::impl::runtime_error,
+        /// an ::errors::impl::code_error<int>
+        /// or an ::errors::impl::system_error,
+        /// and the others become ::errors::impl::wrap_error.
+        /// So the result is formatted the same as the original chain.
+        ///
+        /// Names of source locations are copied into a process wide table,
+        /// each distinct name once.
+        /// Once the table is full,
+        /// records with new names get an empty source location.
+        ///
+        /// Only the outermost `max_depth` records are decoded,
+        /// the last of them becomes the innermost error.
+        ///
+        /// @param max_depth
+        /// The maximum number of records to decode.
+        ///
+        /// @return
+        /// The error chain, or `nullptr` if there is no record.
+        [[nodiscard]]
+        error_ptr to_error(std::size_t max_depth = default_max_depth) const
+        {
+                std::vector<wire_record> links;
+                links.reserve(std::min(this->count, max_depth));
+                for (auto it = this->begin();
+                     it != this->end() && links.size() < max_depth; ++it) {
+                        links.push_back(*it);
+                }
+                error_ptr result;
+                for (auto it = links.rbegin(); it != links.rend(); ++it) {
+                        result = make_link(*it, std::move(result));
+                }
+                return result;
+        }
+
+    private:
+        wire_chain(std::string_view records, std::size_t count,
+                   std::size_t used) noexcept
+                : records(records)
+                , count(count)
+                , used(used)
+        {
+        }
+
+        static source_location location_of(const wire_record &record)
+        {
+#if defined(ERRORS_USE_STD_SOURCE_LOCATION)
+                // NOTE:
+                // std::source_location cannot be created with given values.
+                static_cast<void>(record);
+                return source_location();
+#else
+                if (!record.has_location) {
+                        return source_location();
+                }
+                auto &strings = detail::wire_strings::instance();
+                const auto *file_name = strings.intern(record.file_name);
+                const auto *function_name =
+                        strings.intern(record.function_name);
+                if (file_name == nullptr || function_name == nullptr) {
+                        return source_location();
+                }
+                return source_location::current(file_name, function_name,
+                                                record.line, record.column);
+#endif
+        }
+
+        static error_ptr make_link(const wire_record &record, error_ptr &&cause)
+        {
+                auto location = location_of(record);
+                std::string message(record.message);
+
+                if (cause == nullptr) {
+                        switch (record.tag) {
+                        case wire_tag::system:
+                                // NOTE:
+                                // An empty message is written
+                                // by a system_error without a message.
+                                if (message.empty()) {
+                                        return detail::make<
+                                                impl::system_error>::
+                                                with(record.code,
+                                                     std::move(location));
+                                }
+                                return detail::make<impl::system_error>::with(
+                                        std::move(message), record.code,
+                                        std::move(location));
+                        case wire_tag::code:
+                                return detail::make<impl::code_error<int>>::
+                                        with(std::move(message), record.code,
+                                             std::move(location));
+                        default:
+                                return detail::make<impl::runtime_error>::with(
+                                        std::move(message),
+                                        std::move(location));
+                        }
+                }
+
+                if (record.tag == wire_tag::trace) {
+                        return detail::trace(std::move(cause),
+                                             std::move(location));
+                }
+                return detail::make<impl::wrap_error>::with(
+                        std::move(message), std::move(cause),
+                        std::move(location));
+        }
+
+        std::string_view records;
+        std::size_t count;
+        std::size_t used;
+};
+
+}
@@ -1,10 +1,17 @@
 
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "errors/impl/wrap_error.hpp"
+#include "errors/literal.hpp"
 #include "errors/make.hpp"
 #include "errors/source_location.hpp"
 
+#if defined(ERRORS_ENABLE_METRICS)
+#include "errors/metrics.hpp"
+#endif
+
 namespace errors
 {
 
@@ -26,27 +33,69 @@ class wrap : public error_ptr {
              source_location location = source_location::current())
                 : error_ptr(
                           cause != nullptr ?
-                                  static_cast<error_ptr>(
-                                          detail::make<impl::wrap_error>::with(
-                                                  std::move(message),
-                                                  std::move(cause),
-                                                  std::move(location))) :
+                                  make(std::move(location),
+                                       std::move(message), std::move(cause)) :
+                                  nullptr)
+        {
+        }
+
+        /// @brief
+        /// Wraps an error with a null-terminated message.
+        ///
+        /// @details
+        /// The message is copied,
+        /// pass ::ERRORS_LITERAL to keep a pointer to a string literal
+        /// instead.
+        wrap(const char *message, error_ptr &&cause,
+             source_location location = source_location::current())
+                : error_ptr(
+                          cause != nullptr ?
+                                  make(std::move(location), message,
+                                       std::move(cause)) :
+                                  nullptr)
+        {
+        }
+
+        /// @brief
+        /// Wraps an error with a string literal as message.
+        ///
+        /// @details
+        /// The literal is not copied.
+        ///
+        /// @see ::errors::literal
+        wrap(literal message, error_ptr &&cause,
+             source_location location = source_location::current())
+                : error_ptr(
+                          cause != nullptr ?
+                                  make(std::move(location), message,
+                                       std::move(cause)) :
                                   nullptr)
         {
         }
 
         /// @brief
         /// Wraps an error.
+        ///
+        /// @see ::errors::trace
         wrap(error_ptr &&cause,
              source_location location = source_location::current())
                 : error_ptr(
                           cause != nullptr ?
-                                  static_cast<error_ptr>(
-                                          detail::make<impl::wrap_error>::with(
-                                                  std::move(cause),
-                                                  std::move(location))) :
+                                  make(std::move(location),
+                                       std::move(cause)) :
                                   nullptr)
         {
         }
+
+    private:
+        template <typename... Args>
+        static error_ptr make(source_location location, Args &&...args)
+        {
+#if defined(ERRORS_ENABLE_METRICS)
+                detail::count_error<impl::wrap_error>(location);
+#endif
+                return detail::make<impl::wrap_error>::with(
+                        std::forward<Args>(args)..., std::move(location));
+        }
 };
 }
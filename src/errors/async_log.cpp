@@ -0,0 +1 @@
+#include "errors/async_log.hpp"
@@ -0,0 +1 @@
+#include "errors/chain_formatter.hpp"
@@ -0,0 +1 @@
+#include "errors/clone.hpp"
@@ -0,0 +1 @@
+#include "errors/cloneable.hpp"
@@ -0,0 +1 @@
+#include "errors/detail/bounded_sink.hpp"
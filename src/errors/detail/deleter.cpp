@@ -0,0 +1 @@
+#include "errors/detail/deleter.hpp"
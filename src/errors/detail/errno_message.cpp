@@ -0,0 +1 @@
+#include "errors/detail/errno_message.hpp"
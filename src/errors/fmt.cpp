@@ -0,0 +1,3 @@
+#if defined(ERRORS_ENABLE_FMT_SUPPORT)
+#include "errors/fmt.hpp"
+#endif
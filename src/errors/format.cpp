@@ -0,0 +1 @@
+#include "errors/format.hpp"
@@ -0,0 +1 @@
+#include "errors/impl/inline_message.hpp"
@@ -0,0 +1 @@
+#include "errors/impl/joined_error.hpp"
@@ -0,0 +1 @@
+#include "errors/impl/sampled_error.hpp"
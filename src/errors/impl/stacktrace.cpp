@@ -0,0 +1 @@
+#include "errors/impl/stacktrace.hpp"
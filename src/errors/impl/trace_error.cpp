@@ -0,0 +1 @@
+#include "errors/impl/trace_error.hpp"
@@ -0,0 +1 @@
+#include "errors/intern.hpp"
@@ -0,0 +1 @@
+#include "errors/join.hpp"
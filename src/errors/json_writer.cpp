@@ -0,0 +1 @@
+#include "errors/json_writer.hpp"
@@ -0,0 +1 @@
+#include "errors/literal.hpp"
@@ -0,0 +1 @@
+#include "errors/memory_resource.hpp"
@@ -0,0 +1 @@
+#include "errors/metrics.hpp"
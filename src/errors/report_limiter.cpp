@@ -0,0 +1 @@
+#include "errors/report_limiter.hpp"
@@ -0,0 +1 @@
+#include "errors/shared_error.hpp"
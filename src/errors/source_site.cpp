@@ -0,0 +1 @@
+#include "errors/source_site.hpp"
@@ -0,0 +1 @@
+#include "errors/stacktrace.hpp"
@@ -0,0 +1 @@
+#include "errors/trace.hpp"
@@ -0,0 +1 @@
+#include "errors/type_id.hpp"
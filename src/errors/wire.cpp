@@ -0,0 +1 @@
+#include "errors/wire.hpp"
@@ -0,0 +1,162 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<std::size_t> allocation_count{ 0 };
+std::atomic<std::size_t> allocation_bytes{ 0 };
+
+void *allocate(std::size_t size)
+{
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (size == 0) {
+                size = 1;
+        }
+
+        auto *ptr = std::malloc(size);
+        if (ptr == nullptr) {
+                throw std::bad_alloc();
+        }
+        return ptr;
+}
+
+void *allocate(std::size_t size, std::align_val_t align)
+{
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        auto alignment = static_cast<std::size_t>(align);
+        // NOTE:
+        // std::aligned_alloc requires size to be a multiple of alignment.
+        size = (size + alignment - 1) / alignment * alignment;
+        if (size == 0) {
+                size = alignment;
+        }
+
+        auto *ptr = std::aligned_alloc(alignment, size);
+        if (ptr == nullptr) {
+                throw std::bad_alloc();
+        }
+        return ptr;
+}
+}
+
+namespace benchmarks
+{
+
+allocations allocations::current() noexcept
+{
+        return { allocation_count.load(std::memory_order_relaxed),
+                 allocation_bytes.load(std::memory_order_relaxed) };
+}
+
+void report_allocations(benchmark::State &state, const allocations &start,
+                        const allocations &excluded)
+{
+        auto measured = allocations::current() - start - excluded;
+        state.counters["allocs/op"] =
+                benchmark::Counter(static_cast<double>(measured.count),
+                                   benchmark::Counter::kAvgIterations);
+        state.counters["bytes/op"] =
+                benchmark::Counter(static_cast<double>(measured.bytes),
+                                   benchmark::Counter::kAvgIterations);
+}
+
+}
+
+// NOTE:
+// Replace the global allocation functions
+// to count allocations made by the benchmarked code.
+
+void *operator new(std::size_t size)
+{
+        return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+        return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+        return allocate(size, align);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align)
+{
+        return allocate(size, align);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+        try {
+                return allocate(size);
+        } catch (...) {
+                return nullptr;
+        }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+        try {
+                return allocate(size);
+        } catch (...) {
+                return nullptr;
+        }
+}
+
+void operator delete(void *ptr) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+        std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+        std::free(ptr);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+
+namespace benchmarks
+{
+
+/// @brief
+/// Snapshot of the global allocation counters
+/// maintained by the replaced `operator new`.
+struct allocations {
+        std::size_t count;
+        std::size_t bytes;
+
+        /// @brief
+        /// Get the current values of the global allocation counters.
+        static allocations current() noexcept;
+
+        allocations &operator+=(const allocations &other) noexcept
+        {
+                this->count += other.count;
+                this->bytes += other.bytes;
+                return *this;
+        }
+
+        allocations operator-(const allocations &other) const noexcept
+        {
+                return { this->count - other.count, this->bytes - other.bytes };
+        }
+};
+
+/// @brief
+/// Report allocations/op and bytes/op since `start` as benchmark counters.
+///
+/// @param excluded
+/// Allocations made while timing was paused,
+/// which should not be counted.
+void report_allocations(benchmark::State &state, const allocations &start,
+                        const allocations &excluded = { 0, 0 });
+
+}
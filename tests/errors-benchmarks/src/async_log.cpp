@@ -0,0 +1,62 @@
+#include <cerrno>
+#include <iterator>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+error_ptr make_error()
+{
+        return errors::wrap("failed to read config",
+                            errors::make<system_error>::with("open", ENOENT));
+}
+
+// NOTE:
+// Compare with formatting and writing on the calling thread.
+void log_sync(benchmark::State &state)
+{
+        auto fd = ::open("/dev/null", O_WRONLY);
+        std::string buffer;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto err = make_error();
+                buffer.clear();
+                errors::format_to(std::back_inserter(buffer), err);
+                buffer.push_back('\n');
+                benchmark::DoNotOptimize(
+                        ::write(fd, buffer.data(), buffer.size()));
+        }
+        benchmarks::report_allocations(state, start);
+        ::close(fd);
+}
+BENCHMARK(log_sync);
+
+void log_async(benchmark::State &state)
+{
+        auto fd = ::open("/dev/null", O_WRONLY);
+        {
+                errors::async_log log(fd);
+
+                auto start = benchmarks::allocations::current();
+                for (auto _ : state) {
+                        benchmark::DoNotOptimize(log.push(make_error()));
+                }
+                benchmarks::report_allocations(state, start);
+                state.counters["dropped"] =
+                        static_cast<double>(log.stats().dropped);
+        }
+        ::close(fd);
+}
+BENCHMARK(log_async);
+
+}
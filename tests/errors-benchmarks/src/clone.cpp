@@ -0,0 +1,49 @@
+#include <cerrno>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+using ::errors::impl::trace_error;
+
+namespace
+{
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+void clone_chain(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto copy = errors::clone(err);
+                benchmark::DoNotOptimize(copy.get());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(clone_chain)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+// NOTE:
+// Walk the whole chain, the innermost error is not a runtime_error.
+void is_miss_cloned(benchmark::State &state)
+{
+        auto err = errors::clone(make_chain(state.range(0)));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.is<trace_error>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_miss_cloned)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+}
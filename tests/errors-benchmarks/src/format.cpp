@@ -0,0 +1,172 @@
+#include <exception>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+void what_exception_error(benchmark::State &state)
+{
+        error_ptr err = errors::make<errors::impl::exception_error>::with(
+                std::make_exception_ptr(std::runtime_error("error")));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err->what());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(what_exception_error);
+
+void format_ostream(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        std::ostringstream os;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                os.str("");
+                os << err;
+                benchmark::DoNotOptimize(os);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_ostream)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void format_to_buffer(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        std::string buffer(errors::formatted_size(err), '\0');
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto size =
+                        errors::format_to(buffer.data(), buffer.size(), err);
+                benchmark::DoNotOptimize(size);
+                benchmark::DoNotOptimize(buffer);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_to_buffer)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+struct system_error_format {
+        using error_type = system_error;
+
+        static void format(errors::format_writer &out, const system_error &err)
+        {
+                out.write(err.message.view());
+                out.write(" [errno=");
+                out.write(err.code);
+                out.write(']');
+        }
+};
+
+struct exception_error_format {
+        using error_type = errors::impl::exception_error;
+
+        static void format(errors::format_writer &out,
+                           const errors::impl::exception_error &err)
+        {
+                out.write("exception: ");
+                out.write(err.what());
+        }
+};
+
+void format_chain_formatter(benchmark::State &state)
+{
+        using formatter = errors::chain_formatter<exception_error_format,
+                                                  system_error_format>;
+
+        auto err = make_chain(state.range(0));
+        std::string buffer(formatter::formatted_size(err), '\0');
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto size = formatter::format_to(buffer.data(), buffer.size(),
+                                                 err);
+                benchmark::DoNotOptimize(size);
+                benchmark::DoNotOptimize(buffer);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_chain_formatter)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+#if defined(ERRORS_ENABLE_FMT_SUPPORT)
+
+void format_fmt(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        fmt::memory_buffer buffer;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                buffer.clear();
+                fmt::format_to(std::back_inserter(buffer), "{}", err);
+                benchmark::DoNotOptimize(buffer);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_fmt)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+#endif
+
+void format_json_writer(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        std::string str;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                str.clear();
+                errors::write_json(str, err);
+                benchmark::DoNotOptimize(str);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_json_writer)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+#if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
+
+void format_json(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                nlohmann::json j = err;
+                auto str = j.dump();
+                benchmark::DoNotOptimize(str);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_json)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+#endif
+
+}
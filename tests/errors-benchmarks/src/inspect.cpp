@@ -0,0 +1,173 @@
+#include <string>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::wrap_error;
+
+namespace
+{
+
+// NOTE:
+// A user defined error type like the one in examples/advanced-usage.
+class custom_error_t : public wrap_error {
+    public:
+        custom_error_t(int depth, error_ptr &&cause, source_location location)
+                : wrap_error("[depth=" + std::to_string(depth) + "]",
+                             std::move(cause), std::move(location))
+                , depth(depth)
+        {
+        }
+
+        int depth;
+};
+
+// NOTE:
+// The same error type registered for fast type checking.
+class registered_custom_error_t : public wrap_error {
+        ERRORS_REGISTER_TYPE(registered_custom_error_t, wrap_error);
+
+    public:
+        registered_custom_error_t(int depth, error_ptr &&cause,
+                                  source_location location)
+                : wrap_error("[depth=" + std::to_string(depth) + "]",
+                             std::move(cause), std::move(location))
+                , depth(depth)
+        {
+        }
+
+        int depth;
+};
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        err = errors::make<custom_error_t>::with(0, std::move(err));
+        err = errors::make<registered_custom_error_t>::with(0, std::move(err));
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+// NOTE:
+// The innermost error is a runtime_error,
+// so looking for it walks through the whole chain.
+void is_hit(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.is<runtime_error>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_hit)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void is_miss(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.is<system_error>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_miss)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void is_custom_hit(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.is<custom_error_t>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_custom_hit)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void is_registered_custom_hit(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.is<registered_custom_error_t>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_registered_custom_hit)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+// NOTE:
+// Classify an error by checking several types one after another.
+void is_dispatch(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto kind = err.is<errors::impl::exception_error>() ? 1 :
+                            err.is<system_error>()                   ? 2 :
+                            err.is<errors::impl::code_error<int>>()  ? 3 :
+                            err.is<runtime_error>()                  ? 4 :
+                                                                       0;
+                benchmark::DoNotOptimize(kind);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(is_dispatch)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+// NOTE:
+// Classify an error by checking several types in one pass.
+void match_dispatch(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto kind = err.match<errors::impl::exception_error,
+                                      system_error,
+                                      errors::impl::code_error<int>,
+                                      runtime_error>()
+                                    .index();
+                benchmark::DoNotOptimize(kind);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(match_dispatch)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void as_hit(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.as<runtime_error>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(as_hit)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void as_miss(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(err.as<system_error>());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(as_miss)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+}
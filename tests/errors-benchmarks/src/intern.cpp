@@ -0,0 +1,36 @@
+#include <cerrno>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+void intern_duplicate(benchmark::State &state)
+{
+        errors::intern_table table;
+        auto first = table.intern(make_chain(state.range(0)));
+        benchmark::DoNotOptimize(first.str());
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto err = table.intern(make_chain(state.range(0)));
+                benchmark::DoNotOptimize(err.str());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(intern_duplicate)->ArgName("depth")->RangeMultiplier(4)->Range(1, 16);
+
+}
@@ -0,0 +1,55 @@
+#include <cerrno>
+#include <cstdint>
+#include <vector>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+// NOTE:
+// What a batch API returns without errors::join.
+void batch_vector(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                std::vector<error_ptr> errors;
+                errors.reserve(state.range(0));
+                for (std::int64_t i = 0; i < state.range(0); ++i) {
+                        errors.push_back(errors::make<system_error>::with(
+                                "write", ENOSPC));
+                }
+                benchmark::DoNotOptimize(errors.data());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(batch_vector)
+        ->ArgName("items")
+        ->RangeMultiplier(10)
+        ->Range(10, 10000);
+
+void batch_join_entries(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                errors::batch errors;
+                errors.reserve(state.range(0));
+                for (std::int64_t i = 0; i < state.range(0); ++i) {
+                        errors.add(static_cast<std::uint32_t>(i), ENOSPC,
+                                   ERRORS_LITERAL("write"));
+                }
+                error_ptr err = errors::join("bulk write", std::move(errors));
+                benchmark::DoNotOptimize(err.get());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(batch_join_entries)
+        ->ArgName("items")
+        ->RangeMultiplier(10)
+        ->Range(10, 10000);
+
+}
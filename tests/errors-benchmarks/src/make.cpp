@@ -0,0 +1,131 @@
+#include <cerrno>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::code_error;
+using ::errors::impl::exception_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::wrap_error;
+
+namespace
+{
+
+// NOTE:
+// The short message fits in the SSO buffer of libstdc++,
+// the long one does not.
+// Both fit in ::errors::impl::inline_message.
+constexpr const char *short_message = "error";
+constexpr const char *long_message = "failed to read configuration file";
+
+void make_runtime_error(benchmark::State &state)
+{
+        auto message = state.range(0) != 0 ? long_message : short_message;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with(message);
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_runtime_error)->ArgName("long")->Arg(0)->Arg(1);
+
+void make_runtime_error_literal(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with(
+                        ERRORS_LITERAL("failed to read configuration file"));
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_runtime_error_literal);
+
+void make_code_error(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err =
+                        errors::make<code_error<int>>::with(short_message, 42);
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_code_error);
+
+void make_system_error(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<system_error>::with(short_message,
+                                                                 ENOENT);
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_system_error);
+
+void make_system_error_from_code(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<system_error>::with(ENOENT);
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_system_error_from_code);
+
+void make_exception_error(benchmark::State &state)
+{
+        auto exception =
+                std::make_exception_ptr(std::runtime_error(short_message));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err =
+                        errors::make<exception_error>::with(exception);
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_exception_error);
+
+void make_wrap_error(benchmark::State &state)
+{
+        constexpr std::size_t batch_size = 1024;
+        std::vector<error_ptr> causes(batch_size);
+        auto next = batch_size;
+
+        benchmarks::allocations excluded{ 0, 0 };
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                if (next == batch_size) {
+                        state.PauseTiming();
+                        auto before = benchmarks::allocations::current();
+                        for (auto &cause : causes) {
+                                cause = errors::make<runtime_error>::with(
+                                        short_message);
+                        }
+                        excluded += benchmarks::allocations::current() - before;
+                        next = 0;
+                        state.ResumeTiming();
+                }
+
+                error_ptr err = errors::make<wrap_error>::with(
+                        std::string(short_message), std::move(causes[next++]));
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start, excluded);
+}
+BENCHMARK(make_wrap_error);
+
+}
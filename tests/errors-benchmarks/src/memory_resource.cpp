@@ -0,0 +1,62 @@
+#include <array>
+#include <memory_resource>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+
+namespace
+{
+
+void make_runtime_error_arena(benchmark::State &state)
+{
+        std::array<std::byte, 4096> buffer;
+        std::pmr::monotonic_buffer_resource arena(
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+        errors::memory_resource_scope scope(&arena);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                {
+                        error_ptr err =
+                                errors::make<runtime_error>::with("error");
+                        benchmark::DoNotOptimize(err);
+                }
+                arena.release();
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(make_runtime_error_arena);
+
+void wrap_chain_with_message_arena(benchmark::State &state)
+{
+        auto depth = state.range(0);
+
+        std::array<std::byte, 16 * 1024> buffer;
+        std::pmr::monotonic_buffer_resource arena(
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+        errors::memory_resource_scope scope(&arena);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                {
+                        error_ptr err =
+                                errors::make<runtime_error>::with("error");
+                        for (auto i = 0; i < depth; ++i) {
+                                err = errors::wrap("failed to read config",
+                                                   std::move(err));
+                        }
+                        benchmark::DoNotOptimize(err);
+                }
+                arena.release();
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wrap_chain_with_message_arena)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+}
@@ -0,0 +1,45 @@
+#include <string>
+#include <typeinfo>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+
+namespace
+{
+
+// NOTE:
+// The benchmarks are built without ERRORS_ENABLE_METRICS,
+// so this measures the hook of errors::make and errors::wrap
+// as if it was enabled.
+void metrics_record(benchmark::State &state)
+{
+        auto location = source_location::current();
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                errors::detail::record_error(typeid(runtime_error), location);
+                benchmark::ClobberMemory();
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(metrics_record);
+
+void metrics_snapshot(benchmark::State &state)
+{
+        errors::detail::record_error(typeid(runtime_error),
+                                     source_location::current());
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                std::string out;
+                errors::write_prometheus(out);
+                benchmark::DoNotOptimize(out);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(metrics_snapshot);
+
+}
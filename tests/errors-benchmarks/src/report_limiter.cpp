@@ -0,0 +1,52 @@
+#include <cerrno>
+#include <sstream>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+// NOTE:
+// Compare with printing every error of a storm.
+void report_unlimited(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        std::ostringstream os;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                os << err << '\n';
+                os.str("");
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(report_unlimited)->ArgName("depth")->RangeMultiplier(4)->Range(1, 16);
+
+void report_limited(benchmark::State &state)
+{
+        errors::report_limiter limiter;
+        auto err = make_chain(state.range(0));
+        std::ostringstream os;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(limiter.report(os, err));
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(report_limited)->ArgName("depth")->RangeMultiplier(4)->Range(1, 16);
+
+}
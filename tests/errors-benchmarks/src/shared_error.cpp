@@ -0,0 +1,44 @@
+#include <cerrno>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+template <typename Shared>
+void shared_error_copy(benchmark::State &state)
+{
+        Shared shared = errors::wrap(
+                "failed to read config",
+                errors::make<system_error>::with("open", ENOENT));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto copy = shared;
+                benchmark::DoNotOptimize(copy.get());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK_TEMPLATE(shared_error_copy, errors::shared_error);
+BENCHMARK_TEMPLATE(shared_error_copy, errors::local_shared_error);
+
+void shared_error_wrap(benchmark::State &state)
+{
+        errors::shared_error shared = errors::wrap(
+                "failed to read config",
+                errors::make<system_error>::with("open", ENOENT));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::wrap("failed to start", shared);
+                benchmark::DoNotOptimize(err.get());
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(shared_error_wrap);
+
+}
@@ -0,0 +1,34 @@
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::source_location;
+using ::errors::source_site;
+
+namespace
+{
+
+void intern_source_site(benchmark::State &state)
+{
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                source_site site(source_location::current());
+                benchmark::DoNotOptimize(site);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(intern_source_site);
+
+void load_source_site(benchmark::State &state)
+{
+        source_site site(source_location::current());
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto location = site.location();
+                benchmark::DoNotOptimize(location);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(load_source_site);
+
+}
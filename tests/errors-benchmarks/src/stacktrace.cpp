@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <string>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+
+namespace
+{
+
+void make_sampled(benchmark::State &state)
+{
+        errors::sample_stacktraces<runtime_error>(
+                static_cast<std::uint32_t>(state.range(0)));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with(
+                        ERRORS_LITERAL("failed to read configuration file"));
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+
+        errors::sample_stacktraces<runtime_error>(0);
+}
+BENCHMARK(make_sampled)->ArgName("one_in")->Arg(0)->Arg(64)->Arg(1);
+
+void format_sampled(benchmark::State &state)
+{
+        errors::sample_stacktraces<runtime_error>(1);
+        error_ptr err = errors::wrap(
+                "wrap", errors::make<runtime_error>::with("error"));
+        errors::sample_stacktraces<runtime_error>(0);
+
+        // NOTE:
+        // Symbols are looked up by the first iteration only.
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                std::string out;
+                errors::format_to(out, err, errors::format_style::located);
+                benchmark::DoNotOptimize(out);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(format_sampled);
+
+}
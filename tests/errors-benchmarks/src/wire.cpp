@@ -0,0 +1,71 @@
+#include <cerrno>
+#include <string>
+
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::wire_chain;
+using ::errors::impl::system_error;
+
+namespace
+{
+
+error_ptr make_chain(std::int64_t depth)
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        for (auto i = 1; i < depth; ++i) {
+                err = errors::wrap("failed to read config", std::move(err));
+        }
+        return err;
+}
+
+void wire_encode(benchmark::State &state)
+{
+        auto err = make_chain(state.range(0));
+        std::string str;
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                str.clear();
+                errors::write_binary(str, err);
+                benchmark::DoNotOptimize(str);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wire_encode)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void wire_decode(benchmark::State &state)
+{
+        std::string str;
+        errors::write_binary(str, make_chain(state.range(0)));
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                std::size_t size = 0;
+                auto chain = wire_chain::parse(str);
+                for (const auto &record : *chain) {
+                        size += record.message.size();
+                }
+                benchmark::DoNotOptimize(size);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wire_decode)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+void wire_to_error(benchmark::State &state)
+{
+        std::string str;
+        errors::write_binary(str, make_chain(state.range(0)));
+        auto chain = wire_chain::parse(str);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                auto err = chain->to_error();
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wire_to_error)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+}
@@ -0,0 +1,65 @@
+#include "allocation_counter.hpp"
+#include "errors/errors.hpp"
+
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+
+namespace
+{
+
+void wrap_chain_with_message(benchmark::State &state)
+{
+        auto depth = state.range(0);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with("error");
+                for (auto i = 0; i < depth; ++i) {
+                        err = errors::wrap("failed to read config",
+                                           std::move(err));
+                }
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wrap_chain_with_message)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+void wrap_chain_location_only(benchmark::State &state)
+{
+        auto depth = state.range(0);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with("error");
+                for (auto i = 0; i < depth; ++i) {
+                        err = errors::wrap(std::move(err));
+                }
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(wrap_chain_location_only)
+        ->ArgName("depth")
+        ->RangeMultiplier(4)
+        ->Range(1, 64);
+
+void trace_chain(benchmark::State &state)
+{
+        auto depth = state.range(0);
+
+        auto start = benchmarks::allocations::current();
+        for (auto _ : state) {
+                error_ptr err = errors::make<runtime_error>::with("error");
+                for (auto i = 0; i < depth; ++i) {
+                        err = errors::trace(std::move(err));
+                }
+                benchmark::DoNotOptimize(err);
+        }
+        benchmarks::report_allocations(state, start);
+}
+BENCHMARK(trace_chain)->ArgName("depth")->RangeMultiplier(4)->Range(1, 64);
+
+}
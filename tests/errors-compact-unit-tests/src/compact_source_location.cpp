@@ -0,0 +1,46 @@
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+#if !defined(ERRORS_COMPACT_SOURCE_LOCATION)
+#error "ERRORS_COMPACT_SOURCE_LOCATION is not defined"
+#endif
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::trace_error;
+
+error_ptr fn(source_location &location)
+{
+        location = source_location::current();
+        return errors::make<runtime_error>::with("error");
+}
+}
+
+TEST_CASE("builtin errors store source_site", "[errors][source_site]")
+{
+        STATIC_REQUIRE(sizeof(errors::detail::stored_location) ==
+                       sizeof(errors::source_site));
+
+        source_location expected;
+        error_ptr err = fn(expected);
+
+        auto location = err->location();
+        REQUIRE(location.has_value());
+        REQUIRE(location->line() == expected.line() + 1);
+        REQUIRE(location->file_name() == expected.file_name());
+
+        for (int i = 0; i < 3; ++i) {
+                err = errors::trace(std::move(err));
+        }
+        const auto line = source_location::current().line();
+        err = errors::trace(std::move(err));
+
+        const auto *trace = err.as<trace_error>();
+        REQUIRE(trace->size() == 4);
+        REQUIRE(trace->frame(0).line() == line + 1);
+        REQUIRE(trace->frame(1).line() == line - 2);
+        REQUIRE(err->location()->line() == line + 1);
+}
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+#if !defined(ERRORS_ENABLE_METRICS)
+#error "ERRORS_ENABLE_METRICS is not defined"
+#endif
+
+namespace
+{
+using ::errors::error_metric;
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::wrap_error;
+
+error_ptr fn(source_location &location)
+{
+        location = source_location::current();
+        return errors::make<runtime_error>::with("error");
+}
+
+std::uint64_t count_of(const std::vector<error_metric> &metrics,
+                       const std::type_info &type, std::uint_least32_t line)
+{
+        std::uint64_t result = 0;
+        for (const auto &metric : metrics) {
+                auto location = metric.site.location();
+                if (metric.type != nullptr && *metric.type == type &&
+                    location && location->line() == line) {
+                        result += metric.count;
+                }
+        }
+        return result;
+}
+}
+
+TEST_CASE("make and wrap count errors by type and call site",
+          "[errors][metrics]")
+{
+        source_location made;
+        for (int i = 0; i < 3; ++i) {
+                auto err = errors::wrap("wrap", fn(made));
+        }
+        const auto wrapped = source_location::current().line() - 2;
+
+        auto metrics = errors::snapshot_metrics();
+        REQUIRE(count_of(metrics, typeid(runtime_error), made.line() + 1) ==
+                3);
+        REQUIRE(count_of(metrics, typeid(wrap_error), wrapped) == 3);
+
+        // NOTE:
+        // Wrapping nothing creates no error.
+        auto none = errors::wrap("wrap", nullptr);
+        const auto skipped = source_location::current().line() - 1;
+        REQUIRE(count_of(errors::snapshot_metrics(), typeid(wrap_error),
+                         skipped) == 0);
+}
+
+TEST_CASE("metrics of all threads are added up", "[errors][metrics]")
+{
+        source_location made;
+        auto err = fn(made);
+        auto line = made.line() + 1;
+        auto base = count_of(errors::snapshot_metrics(),
+                             typeid(runtime_error), line);
+
+        constexpr int threads = 4;
+        constexpr int rounds = 1000;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([]() {
+                        source_location location;
+                        for (int j = 0; j < rounds; ++j) {
+                                auto err = fn(location);
+                        }
+                });
+        }
+        for (auto &worker : workers) {
+                worker.join();
+        }
+
+        // NOTE:
+        // The threads have exited, their counts are kept.
+        REQUIRE(count_of(errors::snapshot_metrics(), typeid(runtime_error),
+                         line) == base + threads * rounds);
+}
+
+TEST_CASE("write_prometheus writes counters", "[errors][metrics]")
+{
+        source_location made;
+        auto err = fn(made);
+
+        std::string out;
+        errors::write_prometheus(out);
+
+        REQUIRE(out.rfind("# HELP errors_created_total ", 0) == 0);
+        REQUIRE(out.find("# TYPE errors_created_total counter\n") !=
+                std::string::npos);
+
+        auto label = std::string("errors_created_total{"
+                                 "type=\"errors::impl::runtime_error\",") +
+                     "file=\"" + made.file_name() + "\"";
+        REQUIRE(out.find(label) != std::string::npos);
+        REQUIRE(out.find(",line=\"" + std::to_string(made.line() + 1) +
+                         "\"") != std::string::npos);
+}
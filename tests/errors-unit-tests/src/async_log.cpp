@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::async_log;
+using ::errors::error_ptr;
+using ::errors::overflow_policy;
+using ::errors::impl::runtime_error;
+
+std::string read_all(int fd)
+{
+        std::string result;
+        char buffer[4096];
+        for (;;) {
+                auto size = ::read(fd, buffer, sizeof(buffer));
+                if (size <= 0) {
+                        return result;
+                }
+                result.append(buffer, static_cast<std::size_t>(size));
+        }
+}
+
+std::size_t count_lines(const std::string &str)
+{
+        std::size_t result = 0;
+        for (auto c : str) {
+                result += c == '\n' ? 1 : 0;
+        }
+        return result;
+}
+}
+
+TEST_CASE("async_log writes errors in order", "[errors][async_log]")
+{
+        auto *file = std::tmpfile();
+        REQUIRE(file != nullptr);
+
+        {
+                async_log log(fileno(file));
+                REQUIRE(log.push(nullptr));
+                for (int i = 0; i < 100; ++i) {
+                        REQUIRE(log.push(errors::wrap(
+                                "request " + std::to_string(i),
+                                errors::make<runtime_error>::with("timeout"))));
+                }
+                log.flush();
+                REQUIRE(log.stats().written == 100);
+                REQUIRE(log.stats().dropped == 0);
+
+                REQUIRE(log.push(errors::make<runtime_error>::with("last")));
+        }
+
+        std::rewind(file);
+        auto output = read_all(fileno(file));
+        std::fclose(file);
+
+        REQUIRE(count_lines(output) == 101);
+        REQUIRE(output.rfind("request 0: timeout\nrequest 1: timeout\n", 0) ==
+                0);
+        REQUIRE(output.size() - output.rfind("request 99: timeout\nlast\n") ==
+                sizeof("request 99: timeout\nlast\n") - 1);
+}
+
+TEST_CASE("async_log drops errors when full", "[errors][async_log]")
+{
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+
+        // NOTE:
+        // Nothing reads the pipe yet,
+        // so the background thread blocks once it is full.
+        const std::string message(1024, 'x');
+        constexpr int pushed = 1000;
+        std::size_t dropped = 0;
+        std::string output;
+        {
+                async_log log(fds[1], 8);
+                for (int i = 0; i < pushed; ++i) {
+                        if (!log.push(errors::make<runtime_error>::with(
+                                    message))) {
+                                ++dropped;
+                        }
+                }
+                REQUIRE(log.stats().dropped == dropped);
+
+                std::thread reader(
+                        [&output, &fds]() { output = read_all(fds[0]); });
+                log.flush();
+                REQUIRE(log.stats().written == pushed - dropped);
+                ::close(fds[1]);
+                reader.join();
+        }
+        ::close(fds[0]);
+
+        REQUIRE(dropped > 0);
+        REQUIRE(count_lines(output) == pushed - dropped);
+}
+
+TEST_CASE("async_log blocks when full", "[errors][async_log]")
+{
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+
+        std::string output;
+        std::thread reader([&output, &fds]() { output = read_all(fds[0]); });
+
+        constexpr int threads = 4;
+        constexpr int rounds = 1000;
+        std::atomic<int> dropped = 0;
+        {
+                async_log log(fds[1], 8, overflow_policy::block);
+                std::vector<std::thread> workers;
+                for (int i = 0; i < threads; ++i) {
+                        workers.emplace_back([&log, &dropped]() {
+                                for (int j = 0; j < rounds; ++j) {
+                                        if (!log.push(errors::make<
+                                                      runtime_error>::with(
+                                                    "error"))) {
+                                                ++dropped;
+                                        }
+                                }
+                        });
+                }
+                for (auto &worker : workers) {
+                        worker.join();
+                }
+        }
+        ::close(fds[1]);
+        reader.join();
+        ::close(fds[0]);
+
+        REQUIRE(dropped == 0);
+        REQUIRE(count_lines(output) == threads * rounds);
+}
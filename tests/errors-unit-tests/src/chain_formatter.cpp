@@ -0,0 +1,166 @@
+#include <iterator>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::format_writer;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors_unit_tests::to_string;
+
+class stack_error_t : public runtime_error {
+        ERRORS_REGISTER_TYPE(stack_error_t, runtime_error);
+
+    public:
+        stack_error_t(int top, source_location location)
+                : runtime_error("stack error", std::move(location))
+                , top(top)
+        {
+        }
+
+        int top;
+};
+
+class interface_t : public virtual errors::error {
+    public:
+        virtual int value() const noexcept = 0;
+};
+
+class multiple_error_t : public runtime_error, public interface_t {
+    public:
+        multiple_error_t(int value, source_location location)
+                : runtime_error("multiple", std::move(location))
+                , value_(value)
+        {
+        }
+
+        int value() const noexcept override
+        {
+                return this->value_;
+        }
+
+    private:
+        int value_;
+};
+
+struct stack_error_format {
+        using error_type = stack_error_t;
+
+        static void format(format_writer &out, const stack_error_t &err)
+        {
+                out.write("stack error [top=");
+                out.write(err.top);
+                out.write(']');
+        }
+};
+
+struct system_error_format {
+        using error_type = system_error;
+
+        static void format(format_writer &out, const system_error &err)
+        {
+                out.write(err.message.view());
+                out.write(" (errno ");
+                out.write(err.code);
+                out.write(')');
+        }
+};
+
+struct interface_format {
+        using error_type = interface_t;
+
+        static void format(format_writer &out, const interface_t &err)
+        {
+                out.write("value=");
+                out.write(err.value());
+        }
+};
+
+struct runtime_error_format {
+        using error_type = runtime_error;
+
+        static void format(format_writer &, const runtime_error &)
+        {
+        }
+};
+
+using formatter = errors::chain_formatter<stack_error_format,
+                                          system_error_format,
+                                          interface_format>;
+}
+
+TEST_CASE("chain_formatter dispatches to hooks by error type",
+          "[errors][chain_formatter]")
+{
+        error_ptr err = errors::make<stack_error_t>::with(3);
+        err = errors::wrap("push", std::move(err));
+        err = errors::wrap(std::move(err));
+
+        std::string out;
+        // NOTE:
+        // Format twice to use the cached hooks.
+        for (int i = 0; i < 2; ++i) {
+                out.clear();
+                auto size = formatter::format_to(out, err);
+                REQUIRE(out == "push: stack error [top=3]");
+                REQUIRE(size == out.size());
+        }
+
+        err = errors::wrap("open config",
+                           errors::make<system_error>::with("open", ENOENT));
+        out.clear();
+        formatter::format_to(out, err);
+        REQUIRE(out == "open config: open (errno " + std::to_string(ENOENT) +
+                               ")");
+        REQUIRE(formatter::formatted_size(err) == out.size());
+
+        std::string iterated;
+        formatter::format_to(std::back_inserter(iterated), err);
+        REQUIRE(iterated == out);
+
+        char buffer[8];
+        REQUIRE(formatter::format_to(buffer, sizeof(buffer), err) ==
+                out.size());
+        REQUIRE(std::string(buffer, sizeof(buffer)) ==
+                out.substr(0, sizeof(buffer)));
+}
+
+TEST_CASE("chain_formatter adjusts pointers to the type of hooks",
+          "[errors][chain_formatter]")
+{
+        for (int i = 0; i < 3; ++i) {
+                auto err = errors::wrap(
+                        "outer", errors::make<multiple_error_t>::with(i));
+
+                std::string out;
+                formatter::format_to(out, err);
+                REQUIRE(out == "outer: value=" + std::to_string(i));
+        }
+}
+
+TEST_CASE("chain_formatter without hooks writes the same as operator<<",
+          "[errors][chain_formatter]")
+{
+        using plain = errors::chain_formatter<>;
+
+        error_ptr err;
+        REQUIRE(plain::formatted_size(err) == sizeof("no error") - 1);
+
+        err = errors::make<runtime_error>::with("");
+        err = errors::wrap("outer", std::move(err));
+        err = errors::wrap(std::move(err));
+
+        std::string out;
+        plain::format_to(out, err);
+        REQUIRE(out == to_string(err));
+
+        out.clear();
+        errors::chain_formatter<runtime_error_format>::format_to(out, err);
+        REQUIRE(out == to_string(err));
+}
@@ -0,0 +1,157 @@
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::exception_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::trace_error;
+using ::errors::impl::wrap_error;
+using ::errors_unit_tests::to_string;
+using ::errors_unit_tests::to_located;
+
+class cloneable_error_t : public runtime_error {
+        ERRORS_CLONEABLE(cloneable_error_t);
+
+    public:
+        cloneable_error_t(int value, source_location location)
+                : runtime_error("cloneable", std::move(location))
+                , value(value)
+        {
+        }
+
+        cloneable_error_t(const cloneable_error_t &other, error_ptr &&cause)
+                : runtime_error(other, std::move(cause))
+                , value(other.value)
+        {
+        }
+
+        int value;
+};
+
+class derived_error_t : public cloneable_error_t {
+    public:
+        derived_error_t(source_location location)
+                : cloneable_error_t(0, std::move(location))
+        {
+        }
+};
+
+const std::pmr::memory_resource *resource_of(const error_ptr &err)
+{
+        return err.get_deleter().resource();
+}
+}
+
+TEST_CASE("clone copies builtin errors", "[errors][clone]")
+{
+        REQUIRE(errors::clone(nullptr) == nullptr);
+
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        err = errors::trace(std::move(err));
+        err = errors::trace(std::move(err));
+        err = errors::wrap(std::string(60, 'x'), std::move(err));
+        err = errors::wrap("read config", std::move(err));
+        err = errors::wrap(std::move(err));
+
+        auto copy = errors::clone(err);
+        REQUIRE(to_located(copy) == to_located(err));
+        REQUIRE(copy.as<system_error>() != err.as<system_error>());
+        REQUIRE(copy.as<system_error>()->code == ENOENT);
+        REQUIRE(copy.as<trace_error>()->size() == 2);
+        REQUIRE(copy.as<trace_error>()->frame(0).line() ==
+                err.as<trace_error>()->frame(0).line());
+
+        // NOTE:
+        // All errors of the copy come from the same block.
+        REQUIRE(resource_of(copy) != nullptr);
+        for (const auto *current = copy.get(); current != nullptr;
+             current = current->cause().get()) {
+                REQUIRE(resource_of(current->cause()) ==
+                        (current->cause() ? resource_of(copy) : nullptr));
+        }
+
+        auto text = to_string(err);
+        err = nullptr;
+        REQUIRE(to_string(copy) == text);
+
+        error_ptr exception =
+                errors::make<exception_error>::with(std::make_exception_ptr(
+                        std::runtime_error("exception")));
+        auto cloned = errors::clone(exception);
+        REQUIRE(std::string(cloned->what()) == "exception");
+        REQUIRE(cloned.as<exception_error>()->exception_ptr ==
+                exception.as<exception_error>()->exception_ptr);
+}
+
+TEST_CASE("clone keeps messages of errors which can not be cloned",
+          "[errors][clone]")
+{
+        error_ptr err =
+                errors::wrap("outer", errors::make<cloneable_error_t>::with(7));
+
+        auto copy = errors::clone(err);
+        REQUIRE(copy.as<cloneable_error_t>()->value == 7);
+        REQUIRE(to_located(copy) == to_located(err));
+
+        error_ptr derived = errors::wrap(
+                "outer", errors::make<derived_error_t>::with());
+        copy = errors::clone(derived);
+        REQUIRE(to_located(copy) == to_located(derived));
+        REQUIRE(!copy.is<cloneable_error_t>());
+        REQUIRE(copy.is<runtime_error>());
+}
+
+TEST_CASE("error::clone releases copies to the memory resource",
+          "[errors][clone]")
+{
+        std::pmr::monotonic_buffer_resource resource;
+        auto err = errors::make<cloneable_error_t>::with(7);
+
+        auto copy = err->clone(&resource, nullptr);
+        REQUIRE(resource_of(copy) == &resource);
+        REQUIRE(copy.as<cloneable_error_t>()->value == 7);
+
+        copy = err->clone(nullptr, nullptr);
+        REQUIRE(resource_of(copy) == nullptr);
+        REQUIRE(copy.as<cloneable_error_t>()->value == 7);
+}
+
+TEST_CASE("clone copies errors referred by shared_error", "[errors][clone]")
+{
+        errors::shared_error shared =
+                errors::make<system_error>::with("open", ENOENT);
+        error_ptr err = errors::wrap("read config", shared);
+
+        auto copy = errors::clone(err);
+        REQUIRE(shared.use_count() == 2);
+        REQUIRE(copy->cause().get() == copy.as<system_error>());
+        REQUIRE(to_string(copy) == to_string(err));
+}
+
+TEST_CASE("clone works with deep chains", "[errors][clone]")
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        for (int i = 0; i < 100; ++i) {
+                err = errors::wrap("wrap", std::move(err));
+        }
+
+        auto copy = errors::clone(err);
+        REQUIRE(to_string(copy) == to_string(err));
+
+        // NOTE:
+        // Errors of the copy can be destroyed in any order.
+        error_ptr cause = std::move(*copy).cause();
+        copy = nullptr;
+        while (cause) {
+                cause = std::move(*cause).cause();
+        }
+}
@@ -82,6 +82,9 @@ TEST_CASE("code_error works", "[errors]")
         REQUIRE(err != nullptr);
         REQUIRE_THAT(err->what(), Equals("open /file/not/exist [code=" +
                                          std::to_string(ENOENT) + "]"));
+        REQUIRE(err->what() == err->what());
+        REQUIRE_THAT(err.as<code_error<int>>()->message.c_str(),
+                     Equals("open /file/not/exist"));
 }
 
 TEST_CASE("exception_error works", "[errors]")
@@ -92,8 +95,11 @@ TEST_CASE("exception_error works", "[errors]")
                 auto err = errors::make<exception_error>::with();
                 REQUIRE(err != nullptr);
                 REQUIRE_THAT(err->what(), Equals("error"));
+                REQUIRE(err->what() == err->what());
                 REQUIRE(err->cause() == nullptr);
                 REQUIRE(std::move(*err).cause() == nullptr);
+                REQUIRE(err.as<exception_error>()->exception_type() ==
+                        &typeid(std::runtime_error));
         }
 
         try {
@@ -102,11 +108,16 @@ TEST_CASE("exception_error works", "[errors]")
                 auto err = errors::make<exception_error>::with();
                 REQUIRE(err != nullptr);
                 REQUIRE_THAT(err->what(), Equals("Unknown exception"));
+                // NOTE:
+                // Not all standard libraries can report the type.
+                const auto *type = err.as<exception_error>()->exception_type();
+                REQUIRE((type == nullptr || *type == typeid(const char *)));
         }
 
         auto err = errors::make<exception_error>::with();
         REQUIRE(err != nullptr);
         REQUIRE_THAT(err->what(), Equals(""));
+        REQUIRE(err.as<exception_error>()->exception_type() == nullptr);
 }
 
 TEST_CASE("system_error works", "[errors]")
@@ -116,13 +127,28 @@ TEST_CASE("system_error works", "[errors]")
         assert(fd < 0);
         auto code = errno;
 
-        auto err = errors::make<system_error>::with("open " + std::string(path),
-                                                    code);
+        error_ptr err = errors::make<system_error>::with(
+                "open " + std::string(path), code);
         REQUIRE(err != nullptr);
         REQUIRE_THAT(
                 err->what(),
                 Equals("open /file/not/exist: No such file or directory [code=" +
                        std::to_string(ENOENT) + "]"));
+        REQUIRE(err.as<system_error>()->code == ENOENT);
+        REQUIRE_THAT(err.as<system_error>()->message.c_str(),
+                     Equals("open /file/not/exist"));
+
+        errno = ENOENT;
+        err = errors::make<system_error>::with();
+        REQUIRE(err.as<system_error>()->message.empty());
+        REQUIRE_THAT(err->what(),
+                     Equals("No such file or directory [code=" +
+                            std::to_string(ENOENT) + "]"));
+
+        err = errors::make<system_error>::with("", ENOENT);
+        REQUIRE_THAT(err->what(),
+                     Equals(": No such file or directory [code=" +
+                            std::to_string(ENOENT) + "]"));
 }
 
 #if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors_unit_tests::to_string;
+
+std::vector<error_ptr> chains()
+{
+        std::vector<error_ptr> result;
+        result.emplace_back(nullptr);
+        result.push_back(errors::make<runtime_error>::with("error"));
+        result.push_back(errors::make<runtime_error>::with(""));
+        result.push_back(errors::wrap(
+                "outer", errors::make<runtime_error>::with("")));
+        result.push_back(errors::wrap(errors::wrap(
+                "middle", errors::make<system_error>::with("open", ENOENT))));
+        result.push_back(errors::trace(errors::wrap(
+                "outer",
+                errors::trace(errors::make<runtime_error>::with("inner")))));
+        return result;
+}
+}
+
+TEST_CASE("format_to writes the same as operator<<", "[errors][format]")
+{
+        for (const auto &err : chains()) {
+                auto expected = to_string(err);
+                REQUIRE(errors::formatted_size(err) == expected.size());
+
+                std::string out = "prefix ";
+                REQUIRE(errors::format_to(out, err) == expected.size());
+                REQUIRE(out == "prefix " + expected);
+
+                std::string iterated;
+                errors::format_to(std::back_inserter(iterated), err);
+                REQUIRE(iterated == expected);
+        }
+}
+
+TEST_CASE("format_to truncates output to the buffer", "[errors][format]")
+{
+        auto err = errors::wrap("outer",
+                                errors::make<runtime_error>::with("inner"));
+        auto expected = std::string("outer: inner");
+
+        REQUIRE(errors::format_to(nullptr, 0, err) == expected.size());
+
+        char buffer[8] = {};
+        REQUIRE(errors::format_to(buffer, sizeof(buffer), err) ==
+                expected.size());
+        REQUIRE(std::string(buffer, sizeof(buffer)) ==
+                expected.substr(0, sizeof(buffer)));
+
+        char large[32] = {};
+        auto size = errors::format_to(large, sizeof(large), err);
+        REQUIRE(std::string(large, size) == expected);
+}
+
+TEST_CASE("format_to writes located style", "[errors][format]")
+{
+        error_ptr err = errors::make<runtime_error>::with("inner");
+        auto line = __LINE__ - 1;
+        err = errors::trace(errors::wrap("outer", std::move(err)));
+
+        std::string out;
+        errors::format_to(out, err, errors::format_style::located);
+
+        auto frame = " at format.cpp " + std::to_string(line) + ":";
+        REQUIRE(out.rfind("\n[function ", 0) == 0);
+        REQUIRE(out.find(frame) != std::string::npos);
+        REQUIRE(out.find("] outer\n[function ") != std::string::npos);
+        REQUIRE(out.size() - out.rfind("] inner") == sizeof("] inner") - 1);
+        REQUIRE(std::count(out.begin(), out.end(), '\n') == 3);
+        REQUIRE(errors::formatted_size(err, errors::format_style::located) ==
+                out.size());
+}
+
+TEST_CASE("format_to writes innermost style", "[errors][format]")
+{
+        auto err = errors::wrap("outer",
+                                errors::make<runtime_error>::with("inner"));
+
+        std::string out;
+        errors::format_to(out, err, errors::format_style::innermost);
+        REQUIRE(out == "inner");
+
+        out.clear();
+        errors::format_to(out, nullptr, errors::format_style::innermost);
+        REQUIRE(out == "no error");
+}
+
+#if defined(ERRORS_ENABLE_FMT_SUPPORT)
+
+#include "fmt/format.h"
+
+TEST_CASE("error_ptr can be formatted by fmt", "[errors][format][fmt]")
+{
+        for (const auto &err : chains()) {
+                REQUIRE(fmt::format("{}", err) == to_string(err));
+                REQUIRE(fmt::format("{:c}", err) == to_string(err));
+
+                std::string located;
+                errors::format_to(located, err, errors::format_style::located);
+                REQUIRE(fmt::format("{:l}", err) == located);
+
+                std::string innermost;
+                errors::format_to(innermost, err,
+                                  errors::format_style::innermost);
+                REQUIRE(fmt::format("{:i}", err) == innermost);
+        }
+
+        REQUIRE_THROWS_AS(fmt::format(fmt::runtime("{:x}"), error_ptr()),
+                          fmt::format_error);
+}
+
+#endif
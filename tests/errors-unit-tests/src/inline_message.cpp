@@ -0,0 +1,113 @@
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::code_error;
+using ::errors::impl::inline_message;
+using ::errors::impl::runtime_error;
+using ::errors::impl::wrap_error;
+
+template <typename E>
+bool stored_in(const error_ptr &err)
+{
+        const auto *begin = static_cast<const char *>(
+                dynamic_cast<const void *>(err.as<E>()));
+        const auto *end = begin + sizeof(E);
+        return std::less_equal<>()(begin, err->what()) &&
+               std::less<>()(err->what(), end);
+}
+
+error_ptr wrap_local_array()
+{
+        const char message[] = "failed to read config";
+        return errors::wrap(message, errors::make<runtime_error>::with("x"));
+}
+
+error_ptr join_local_array()
+{
+        const char message[] = "failed to write all";
+        errors::batch batch;
+        batch.add(errors::make<runtime_error>::with("x"));
+        return errors::join(message, std::move(batch));
+}
+}
+
+TEST_CASE("short messages are stored inline", "[errors][inline_message]")
+{
+        using Catch::Matchers::Equals;
+
+        std::string text(inline_message::inline_capacity, 'x');
+        error_ptr err = errors::make<runtime_error>::with(text);
+        REQUIRE_THAT(err->what(), Equals(text));
+        REQUIRE(err.as<runtime_error>()->message.size() == text.size());
+        REQUIRE(stored_in<runtime_error>(err));
+
+        err = errors::wrap(std::string("failed to read config"),
+                           std::move(err));
+        REQUIRE_THAT(err->what(), Equals("failed to read config"));
+        REQUIRE(stored_in<wrap_error>(err));
+
+        err = errors::make<runtime_error>::with(text + "x");
+        REQUIRE_THAT(err->what(), Equals(text + "x"));
+        REQUIRE(!stored_in<runtime_error>(err));
+
+        err = errors::wrap(errors::make<runtime_error>::with(""));
+        REQUIRE_THAT(err->what(), Equals(""));
+        REQUIRE(err->cause()->what()[0] == '\0');
+}
+
+TEST_CASE("string literals are not copied", "[errors][inline_message]")
+{
+        using Catch::Matchers::Equals;
+
+        constexpr auto text = ERRORS_LITERAL("failed to read config");
+
+        error_ptr err = errors::make<runtime_error>::with(text);
+        REQUIRE(err->what() == text.c_str());
+        REQUIRE(err.as<runtime_error>()->message.view() == text.view());
+
+        err = errors::make<wrap_error>::with(text, std::move(err));
+        REQUIRE(err->what() == text.c_str());
+
+        err = errors::make<code_error<int>>::with(text, 42);
+        REQUIRE(err.as<runtime_error>()->message.c_str() == text.c_str());
+        REQUIRE_THAT(err->what(), Equals("failed to read config [code=42]"));
+}
+
+TEST_CASE("character arrays are copied", "[errors][inline_message]")
+{
+        using Catch::Matchers::Equals;
+
+        // NOTE:
+        // Only errors::literal is kept by pointer,
+        // arrays might not outlive the error.
+        auto err = wrap_local_array();
+        REQUIRE(stored_in<wrap_error>(err));
+        REQUIRE_THAT(err->what(), Equals("failed to read config"));
+
+        err = join_local_array();
+        REQUIRE(std::string(err->what()).rfind("failed to write all", 0) == 0);
+
+        constexpr auto text = ERRORS_LITERAL("failed to read config");
+        err = errors::wrap(text, std::move(err));
+        REQUIRE(err->what() == text.c_str());
+}
+
+TEST_CASE("ERRORS_LITERAL only accepts string literals",
+          "[errors][inline_message]")
+{
+        static_assert(!std::is_constructible_v<errors::literal,
+                                               const char (&)[4]>);
+        static_assert(!std::is_convertible_v<const char *, errors::literal>);
+
+        constexpr auto text = ERRORS_LITERAL("abc\0def");
+        static_assert(text.size() == 3);
+        REQUIRE(text.view() == "abc");
+}
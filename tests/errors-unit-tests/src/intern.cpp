@@ -0,0 +1,138 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::intern_table;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors_unit_tests::to_string;
+
+error_ptr fn(int code)
+{
+        return errors::wrap("read config",
+                            errors::make<system_error>::with("open", code));
+}
+
+error_ptr joined(int code, int entry)
+{
+        errors::batch errors;
+        errors.add(errors::make<system_error>::with("open", code));
+        errors.add(1, entry, ERRORS_LITERAL("read"));
+        return errors::join("batch", std::move(errors));
+}
+
+error_ptr traced(int depth)
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        for (int i = 0; i < depth; ++i) {
+                err = errors::trace(std::move(err));
+        }
+        return err;
+}
+}
+
+TEST_CASE("intern_table shares identical chains", "[errors][intern]")
+{
+        intern_table table;
+
+        auto first = table.intern(fn(ENOENT));
+        for (int i = 0; i < 10; ++i) {
+                auto again = table.intern(fn(ENOENT));
+                REQUIRE(again.get() == first.get());
+        }
+        REQUIRE(table.size() == 1);
+        REQUIRE(first.count() == 11);
+        REQUIRE(first.str() == to_string(first.chain()));
+        REQUIRE(first.chain().as<system_error>()->code == ENOENT);
+
+        auto other = table.intern(fn(EACCES));
+        REQUIRE(other.get() != first.get());
+        REQUIRE(other.count() == 1);
+        REQUIRE(table.size() == 2);
+
+        auto located = table.intern(
+                errors::wrap("read config",
+                             errors::make<system_error>::with("open", ENOENT)));
+        REQUIRE(located.get() != first.get());
+        REQUIRE(table.size() == 3);
+
+        REQUIRE(!table.intern(nullptr));
+        REQUIRE(table.intern(nullptr).str() == "no error");
+}
+
+TEST_CASE("intern_table compares frames of trace", "[errors][intern]")
+{
+        intern_table table;
+
+        auto first = table.intern(traced(3));
+        REQUIRE(table.intern(traced(3)).get() == first.get());
+        REQUIRE(table.intern(traced(4)).get() != first.get());
+        REQUIRE(table.size() == 2);
+}
+
+TEST_CASE("intern_table compares causes of joined errors",
+          "[errors][intern]")
+{
+        intern_table table;
+
+        auto first = table.intern(joined(ENOENT, EIO));
+        REQUIRE(table.intern(joined(ENOENT, EIO)).get() == first.get());
+
+        auto other = table.intern(joined(EACCES, EIO));
+        REQUIRE(other.get() != first.get());
+        REQUIRE(other.chain().as<system_error>()->code == EACCES);
+
+        REQUIRE(table.intern(joined(ENOENT, ENOSPC)).get() != first.get());
+        REQUIRE(table.size() == 3);
+}
+
+TEST_CASE("intern_table stops sharing when full", "[errors][intern]")
+{
+        intern_table table(1);
+
+        auto first = table.intern(fn(ENOENT));
+        auto second = table.intern(fn(EACCES));
+        auto third = table.intern(fn(EACCES));
+        REQUIRE(table.size() == 1);
+        REQUIRE(second.get() != third.get());
+        REQUIRE(table.intern(fn(ENOENT)).get() == first.get());
+
+        table.clear();
+        REQUIRE(table.size() == 0);
+        REQUIRE(first.chain().as<system_error>()->code == ENOENT);
+}
+
+TEST_CASE("intern_table can be used by multiple threads", "[errors][intern]")
+{
+        intern_table table;
+        constexpr int threads = 4;
+        constexpr int rounds = 1000;
+
+        std::atomic<int> formatted = 0;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([&table, &formatted]() {
+                        for (int j = 0; j < rounds; ++j) {
+                                auto err = table.intern(fn(j % 2));
+                                if (!err.str().empty()) {
+                                        ++formatted;
+                                }
+                        }
+                });
+        }
+        for (auto &worker : workers) {
+                worker.join();
+        }
+
+        REQUIRE(formatted == threads * rounds);
+        REQUIRE(table.size() == 2);
+        REQUIRE(table.intern(fn(0)).count() == threads * rounds / 2 + 1);
+}
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::joined_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::wrap_error;
+using ::errors_unit_tests::to_string;
+
+class timeout_error_t : public runtime_error {
+    public:
+        explicit timeout_error_t(source_location location)
+                : runtime_error("timeout", std::move(location))
+        {
+        }
+};
+
+error_ptr write_all()
+{
+        errors::batch errors;
+        errors.add(nullptr);
+        errors.add(errors::wrap("write 1",
+                                errors::make<runtime_error>::with("full")));
+        errors.add(2, ENOSPC, ERRORS_LITERAL("no space"));
+        errors.add(errors::wrap(
+                "write 3", errors::make<system_error>::with("open", EACCES)));
+        errors.add(errors::make<timeout_error_t>::with());
+        return errors::wrap("flush",
+                            errors::join("bulk write", std::move(errors)));
+}
+}
+
+TEST_CASE("join holds causes and entries", "[errors][join]")
+{
+        REQUIRE(errors::join("bulk write", errors::batch()) == nullptr);
+
+        auto err = write_all();
+        const auto *joined = err.as<joined_error>();
+        REQUIRE(joined != nullptr);
+        REQUIRE(joined->causes().size() == 3);
+        REQUIRE(joined->entries().size() == 1);
+        REQUIRE(joined->size() == 4);
+        REQUIRE(joined->entries()[0].index == 2);
+        REQUIRE(joined->entries()[0].code == ENOSPC);
+        REQUIRE(joined->entries()[0].message.view() == "no space");
+        REQUIRE(to_string(err) == "flush: bulk write [errors=4]");
+
+        errors::batch unnamed;
+        unnamed.add(0, 1, ERRORS_LITERAL("failed"));
+        REQUIRE(to_string(errors::join(std::move(unnamed))) == "[errors=1]");
+
+        std::string message(100, 'x');
+        errors::batch many;
+        for (std::uint32_t i = 0; i < 12; ++i) {
+                many.add(i, 1, ERRORS_LITERAL("failed"));
+        }
+        REQUIRE(to_string(errors::join(message, std::move(many))) ==
+                message + " [errors=12]");
+}
+
+TEST_CASE("is and as search causes of joined errors", "[errors][join]")
+{
+        auto err = write_all();
+
+        REQUIRE(err.is<system_error>());
+        REQUIRE(err.as<system_error>()->code == EACCES);
+        REQUIRE(err.as<timeout_error_t>() != nullptr);
+
+        // NOTE:
+        // Causes are searched depth first in the order they were added.
+        REQUIRE(std::string(err.as<runtime_error>()->what()) == "full");
+        REQUIRE(err.as<wrap_error>() == err.get());
+        REQUIRE(err.match<system_error, timeout_error_t>().index() == 1);
+        REQUIRE(std::get<1>(err.match_innermost<runtime_error>()) ==
+                err.as<timeout_error_t>());
+
+        errors::shared_error shared = std::move(err);
+        error_ptr wrapped = errors::wrap("retry", shared);
+        REQUIRE(wrapped.as<timeout_error_t>() == shared.as<timeout_error_t>());
+}
+
+TEST_CASE("joined errors can be cloned", "[errors][join]")
+{
+        auto err = write_all();
+        auto copy = errors::clone(err);
+
+        REQUIRE(to_string(copy) == to_string(err));
+        REQUIRE(copy.as<joined_error>()->size() == 4);
+        REQUIRE(copy.as<system_error>() != err.as<system_error>());
+        REQUIRE(copy.as<system_error>()->code == EACCES);
+        REQUIRE(copy.as<joined_error>()->entries()[0].code == ENOSPC);
+}
@@ -0,0 +1,159 @@
+#include <sstream>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+
+error_ptr fn(int depth)
+{
+        if (depth == 0) {
+                return errors::make<system_error>::with("open", ENOENT);
+        }
+        return errors::wrap("depth=" + std::to_string(depth), fn(depth - 1));
+}
+
+bool ends_with(const std::string &str, const std::string &suffix)
+{
+        return str.size() >= suffix.size() &&
+               str.compare(str.size() - suffix.size(), suffix.size(),
+                           suffix) == 0;
+}
+
+std::string to_json(const error_ptr &err,
+                    errors::json_form form = errors::json_form::nested)
+{
+        std::string result;
+        errors::write_json(result, err, form);
+        return result;
+}
+}
+
+TEST_CASE("write_json writes null error", "[errors][json_writer]")
+{
+        REQUIRE(to_json(nullptr) == "null");
+}
+
+TEST_CASE("write_json escapes strings", "[errors][json_writer]")
+{
+        auto err = errors::make<runtime_error>::with(
+                "quote\" backslash\\ \b\f\n\r\t \x01\x1f \xC3\xA9 bad\xFF");
+        auto json = to_json(err);
+        std::string message = ",\"message\":\"quote\\\" backslash\\\\ "
+                              "\\b\\f\\n\\r\\t \\u0001\\u001f "
+                              "\xC3\xA9 bad\xEF\xBF\xBD\"}";
+        REQUIRE(ends_with(json, message));
+}
+
+TEST_CASE("write_json writes to all kinds of output", "[errors][json_writer]")
+{
+        auto err = fn(40);
+        auto expected = to_json(err);
+        REQUIRE(expected.rfind("{\"caused_by\":", 0) == 0);
+
+        std::ostringstream os;
+        errors::write_json(os, err);
+        REQUIRE(os.str() == expected);
+
+        REQUIRE(errors::write_json(nullptr, 0, err) == expected.size());
+
+        std::string buffer(expected.size() / 2, '\0');
+        REQUIRE(errors::write_json(buffer.data(), buffer.size(), err) ==
+                expected.size());
+        REQUIRE(buffer == expected.substr(0, buffer.size()));
+
+        buffer.assign(expected.size(), '\0');
+        REQUIRE(errors::write_json(buffer.data(), buffer.size(), err) ==
+                expected.size());
+        REQUIRE(buffer == expected);
+}
+
+TEST_CASE("write_json writes flat form", "[errors][json_writer]")
+{
+        REQUIRE(to_json(nullptr, errors::json_form::flat) == "[]");
+
+        auto err = fn(2);
+        auto json = to_json(err, errors::json_form::flat);
+        REQUIRE(json.rfind("[{\"location\":", 0) == 0);
+        REQUIRE(json.find("\"message\":\"depth=2\"},{") != std::string::npos);
+        REQUIRE(json.find("\"message\":\"depth=1\"},{") != std::string::npos);
+        REQUIRE(json.find("caused_by") == std::string::npos);
+        REQUIRE(ends_with(json, "}]"));
+}
+
+TEST_CASE("write_json does not recurse on deep chains",
+          "[errors][json_writer]")
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        for (int i = 0; i < 100000; ++i) {
+                err = errors::wrap(std::move(err));
+        }
+
+        auto json = to_json(err);
+        REQUIRE(json.size() > 100000 * sizeof("{\"caused_by\":"));
+        REQUIRE(ends_with(json, "\"message\":\"\"}"));
+
+        json = to_json(err, errors::json_form::flat);
+        REQUIRE(ends_with(json, "\"message\":\"error\"}]"));
+
+        // NOTE:
+        // Destroy the chain iteratively.
+        while (err) {
+                err = std::move(*err).cause();
+        }
+}
+
+#if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
+
+#include "nlohmann/json.hpp"
+
+TEST_CASE("write_json is the same as dumping nlohmann::json",
+          "[errors][json_writer][json]")
+{
+        for (auto depth : { 0, 1, 3, 31, 32, 33, 100 }) {
+                auto err = fn(depth);
+                REQUIRE(to_json(err) == nlohmann::json(err).dump());
+        }
+
+        error_ptr err = errors::make<runtime_error>::with("\"\n\x01\xC3\xA9");
+        for (int i = 0; i < 10; ++i) {
+                err = errors::trace(std::move(err));
+        }
+        err = errors::wrap(std::move(err));
+        REQUIRE(to_json(err) == nlohmann::json(err).dump());
+        REQUIRE(to_json(err, errors::json_form::flat) ==
+                errors::flat_json(err).dump());
+        REQUIRE(errors::flat_json(err).size() == 12);
+        REQUIRE(errors::flat_json(err)[1]["message"] == "");
+        REQUIRE(errors::flat_json(nullptr) == nlohmann::json::array());
+}
+
+TEST_CASE("to_json does not recurse on deep chains", "[errors][json]")
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        for (int i = 0; i < 10000; ++i) {
+                err = errors::wrap(std::move(err));
+        }
+
+        // NOTE:
+        // Destroying `j` does not recurse either
+        // with the version of nlohmann_json required by this target.
+        nlohmann::json j = err;
+        const auto *node = &j;
+        for (int i = 0; i < 10000; ++i) {
+                node = &(*node)["caused_by"];
+        }
+        REQUIRE((*node)["message"] == "error");
+        REQUIRE(errors::flat_json(err).size() == 10001);
+
+        while (err) {
+                err = std::move(*err).cause();
+        }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include <variant>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::code_error;
+using ::errors::impl::exception_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::wrap_error;
+
+class timeout_error_t : public runtime_error {
+    public:
+        explicit timeout_error_t(source_location location)
+                : runtime_error("timeout", std::move(location))
+        {
+        }
+};
+
+error_ptr fn()
+{
+        return errors::wrap("request",
+                            errors::wrap(errors::make<timeout_error_t>::with()));
+}
+}
+
+TEST_CASE("match finds the first matching error", "[errors][match]")
+{
+        auto err = fn();
+
+        auto matched = err.match<exception_error, system_error, wrap_error>();
+        REQUIRE(matched.index() == 3);
+        REQUIRE(std::get<3>(matched) == err.as<wrap_error>());
+
+        auto timeout = err.match<system_error, timeout_error_t>();
+        REQUIRE(timeout.index() == 2);
+        REQUIRE(std::get<2>(timeout) == err.as<timeout_error_t>());
+
+        // NOTE:
+        // The first type wins if an error matches more than one type.
+        auto runtime = err.match<runtime_error, timeout_error_t>();
+        REQUIRE(runtime.index() == 1);
+        REQUIRE(std::get<1>(runtime) == err.as<runtime_error>());
+
+        auto none = err.match<exception_error, code_error<unsigned int>>();
+        REQUIRE(none.index() == 0);
+
+        REQUIRE(error_ptr().match<runtime_error>().index() == 0);
+        REQUIRE(errors::match<timeout_error_t, system_error>(*err).index() ==
+                1);
+}
+
+TEST_CASE("match_innermost finds the last matching error", "[errors][match]")
+{
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        err = errors::wrap("read", std::move(err));
+
+        auto matched = err.match_innermost<system_error, wrap_error>();
+        REQUIRE(matched.index() == 1);
+        REQUIRE(std::get<1>(matched) == err.as<system_error>());
+
+        auto wrap = err.match_innermost<wrap_error, exception_error>();
+        REQUIRE(wrap.index() == 1);
+        REQUIRE(std::get<1>(wrap) == err.as<wrap_error>());
+}
@@ -0,0 +1,135 @@
+#include <memory_resource>
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+
+class counting_resource : public std::pmr::memory_resource {
+    public:
+        std::size_t allocated = 0;
+        std::size_t deallocated = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+                ++this->allocated;
+                return std::pmr::new_delete_resource()->allocate(bytes,
+                                                                 alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes,
+                           std::size_t alignment) override
+        {
+                ++this->deallocated;
+                std::pmr::new_delete_resource()->deallocate(p, bytes,
+                                                            alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other)
+                const noexcept override
+        {
+                return this == &other;
+        }
+};
+
+error_ptr fn(unsigned int depth)
+{
+        if (depth == 0) {
+                return errors::make<runtime_error>::with("error");
+        }
+        return errors::wrap("depth=" + std::to_string(depth), fn(depth - 1));
+}
+}
+
+TEST_CASE("errors are allocated from memory_resource in scope",
+          "[errors][memory_resource]")
+{
+        using Catch::Matchers::Equals;
+
+        counting_resource resource;
+
+        {
+                REQUIRE(errors::current_memory_resource() == nullptr);
+                errors::memory_resource_scope scope(&resource);
+                REQUIRE(errors::current_memory_resource() == &resource);
+
+                auto err = fn(3);
+                REQUIRE(resource.allocated == 4);
+                REQUIRE(err.get_deleter().resource() == &resource);
+
+                std::stringstream ss;
+                ss << err;
+                REQUIRE_THAT(ss.str(),
+                             Equals("depth=3: depth=2: depth=1: error"));
+
+                auto cause = std::move(*err).cause();
+                REQUIRE(cause.get_deleter().resource() == &resource);
+                err.reset();
+                REQUIRE(resource.deallocated == 1);
+        }
+
+        REQUIRE(errors::current_memory_resource() == nullptr);
+        REQUIRE(resource.deallocated == 4);
+
+        auto err = fn(1);
+        REQUIRE(resource.allocated == 4);
+        REQUIRE(err.get_deleter().resource() == nullptr);
+}
+
+TEST_CASE("error_ptr::reset adopts errors allocated by new",
+          "[errors][memory_resource]")
+{
+        counting_resource resource;
+
+        error_ptr err;
+        {
+                errors::memory_resource_scope scope(&resource);
+                err = errors::make<runtime_error>::with("error");
+        }
+        REQUIRE(err.get_deleter().resource() == &resource);
+
+        err.reset(new runtime_error("error", errors::source_location()));
+        REQUIRE(resource.deallocated == 1);
+        REQUIRE(err.get_deleter().resource() == nullptr);
+
+        err.reset();
+        REQUIRE(resource.deallocated == 1);
+}
+
+TEST_CASE("memory_resource_scope can be nested", "[errors][memory_resource]")
+{
+        counting_resource outer;
+        counting_resource inner;
+
+        errors::memory_resource_scope outer_scope(&outer);
+        error_ptr err = errors::make<runtime_error>::with("error");
+        {
+                errors::memory_resource_scope inner_scope(&inner);
+                err = errors::wrap(std::move(err));
+                REQUIRE(errors::current_memory_resource() == &inner);
+        }
+        REQUIRE(errors::current_memory_resource() == &outer);
+        REQUIRE(outer.allocated == 1);
+        REQUIRE(inner.allocated == 1);
+
+        err.reset();
+        REQUIRE(outer.deallocated == 1);
+        REQUIRE(inner.deallocated == 1);
+}
+
+TEST_CASE("errors can be allocated from monotonic_buffer_resource",
+          "[errors][memory_resource]")
+{
+        std::pmr::monotonic_buffer_resource arena;
+        errors::memory_resource_scope scope(&arena);
+
+        auto err = fn(5);
+        REQUIRE(err.is<runtime_error>());
+        REQUIRE_THAT(err->what(), Catch::Matchers::Equals("depth=5"));
+}
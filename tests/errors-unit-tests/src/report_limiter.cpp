@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::report_limiter;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using std::chrono::seconds;
+
+error_ptr open_file(int code)
+{
+        return errors::wrap("load config",
+                            errors::make<system_error>::with("open", code));
+}
+
+error_ptr read_file()
+{
+        return errors::wrap("load config",
+                            errors::make<runtime_error>::with("read"));
+}
+
+report_limiter::clock::time_point at(int second)
+{
+        return report_limiter::clock::time_point(seconds(second));
+}
+}
+
+TEST_CASE("report_limiter reports the first error of each key",
+          "[errors][report_limiter]")
+{
+        report_limiter limiter;
+        std::ostringstream os;
+
+        REQUIRE(limiter.report(os, open_file(ENOENT), at(100)));
+        REQUIRE(limiter.report(os, read_file(), at(100)));
+        REQUIRE_FALSE(limiter.report(os, nullptr, at(100)));
+
+        // NOTE:
+        // Messages are not part of the key.
+        REQUIRE_FALSE(limiter.report(os, open_file(EACCES), at(100)));
+        REQUIRE_FALSE(limiter.report(os, open_file(ENOENT), at(100)));
+        REQUIRE(limiter.report(os, open_file(EACCES), at(101)));
+
+        REQUIRE(os.str() ==
+                "load config: open: No such file or directory [code=2]\n"
+                "load config: read\n"
+                "load config: open: Permission denied [code=13]"
+                " (suppressed 2 identical errors)\n");
+}
+
+TEST_CASE("report_limiter refills tokens over time",
+          "[errors][report_limiter]")
+{
+        report_limiter limiter(3, seconds(10));
+
+        int reported = 0;
+        for (int i = 0; i < 10; ++i) {
+                reported += limiter.admit(read_file(), at(100)) ? 1 : 0;
+        }
+        REQUIRE(reported == 3);
+        REQUIRE_FALSE(limiter.admit(read_file(), at(105)));
+
+        auto decision = limiter.admit(read_file(), at(110));
+        REQUIRE(decision);
+        REQUIRE(decision.suppressed == 8);
+        REQUIRE_FALSE(limiter.admit(read_file(), at(110)));
+
+        // NOTE:
+        // The bucket holds at most 3 tokens.
+        reported = 0;
+        for (int i = 0; i < 10; ++i) {
+                reported += limiter.admit(read_file(), at(1000)) ? 1 : 0;
+        }
+        REQUIRE(reported == 3);
+}
+
+TEST_CASE("report_limiter summarizes suppressed errors",
+          "[errors][report_limiter]")
+{
+        report_limiter limiter;
+        std::ostringstream os;
+
+        REQUIRE(limiter.report(os, open_file(ENOENT), at(100)));
+        for (int i = 0; i < 5; ++i) {
+                REQUIRE_FALSE(limiter.report(os, open_file(ENOENT), at(100)));
+        }
+        REQUIRE(limiter.admit(read_file(), at(100)));
+        REQUIRE_FALSE(limiter.admit(read_file(), at(100)));
+
+        os.str("");
+        REQUIRE(limiter.summarize(os) == 6);
+        REQUIRE(os.str().find("suppressed 5 identical errors: load config: "
+                              "open: No such file or directory [code=2]\n") !=
+                std::string::npos);
+        REQUIRE(os.str().find("suppressed 1 identical errors\n") !=
+                std::string::npos);
+
+        os.str("");
+        REQUIRE(limiter.summarize(os) == 0);
+        REQUIRE(os.str().empty());
+}
+
+TEST_CASE("report_limiter shares one bucket when full",
+          "[errors][report_limiter]")
+{
+        report_limiter limiter(1, seconds(1), 1);
+
+        REQUIRE(limiter.admit(open_file(ENOENT), at(100)));
+        REQUIRE(limiter.admit(read_file(), at(100)));
+        REQUIRE_FALSE(limiter.admit(errors::make<runtime_error>::with("x"),
+                                    at(100)));
+        REQUIRE_FALSE(limiter.admit(read_file(), at(100)));
+}
+
+TEST_CASE("report_limiter can be used by multiple threads",
+          "[errors][report_limiter]")
+{
+        report_limiter limiter(10, seconds(1000));
+        constexpr int threads = 4;
+        constexpr int rounds = 1000;
+
+        std::atomic<int> reported = 0;
+        std::atomic<std::uint64_t> suppressed = 0;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([&limiter, &reported, &suppressed]() {
+                        for (int j = 0; j < rounds; ++j) {
+                                auto err = j % 2 == 0 ? open_file(ENOENT)
+                                                      : read_file();
+                                auto decision = limiter.admit(err, at(100));
+                                if (decision) {
+                                        ++reported;
+                                        suppressed += decision.suppressed;
+                                }
+                        }
+                });
+        }
+        for (auto &worker : workers) {
+                worker.join();
+        }
+
+        // NOTE:
+        // A report racing with suppressed ones might take their count.
+        suppressed += limiter.summarize(
+                [](std::uint64_t, const std::string &) {});
+        REQUIRE(reported == 20);
+        REQUIRE(suppressed == threads * rounds - 20);
+}
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::local_shared_error;
+using ::errors::shared_error;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::trace_error;
+using ::errors_unit_tests::to_string;
+
+class unregistered_error_t : public runtime_error {
+    public:
+        unregistered_error_t(int value, source_location location)
+                : runtime_error("unregistered", std::move(location))
+                , value(value)
+        {
+        }
+
+        int value;
+};
+
+struct value_format {
+        using error_type = unregistered_error_t;
+
+        static void format(errors::format_writer &out,
+                           const unregistered_error_t &err)
+        {
+                out.write("value=");
+                out.write(err.value);
+        }
+};
+}
+
+TEST_CASE("shared_error copies share one chain", "[errors][shared_error]")
+{
+        shared_error err =
+                errors::wrap("read config",
+                             errors::make<system_error>::with("open", ENOENT));
+        REQUIRE(err.use_count() == 1);
+
+        const auto *outermost = err.get();
+        {
+                auto copy = err;
+                auto other = copy;
+                REQUIRE(err.use_count() == 3);
+                REQUIRE(copy.get() == outermost);
+                REQUIRE(other.chain().get() == outermost);
+        }
+        REQUIRE(err.use_count() == 1);
+
+        REQUIRE(err.is<system_error>());
+        REQUIRE(err.as<system_error>()->code == ENOENT);
+        REQUIRE(!err.is<unregistered_error_t>());
+        REQUIRE(err.match<runtime_error, system_error>().index() == 1);
+
+        auto moved = std::move(err);
+        REQUIRE(err == nullptr);
+        REQUIRE(err.use_count() == 0);
+        REQUIRE(moved.use_count() == 1);
+
+        shared_error none;
+        REQUIRE(!none);
+        REQUIRE(static_cast<error_ptr>(none) == nullptr);
+        REQUIRE(!shared_error(error_ptr()));
+}
+
+TEST_CASE("shared_error can be wrapped", "[errors][shared_error]")
+{
+        shared_error shared = errors::make<system_error>::with("open", ENOENT);
+
+        error_ptr wrapped = errors::wrap("read config", shared);
+        REQUIRE(shared.use_count() == 2);
+        REQUIRE(to_string(wrapped) ==
+                "read config: " + to_string(shared.chain()));
+        REQUIRE(wrapped.as<system_error>() == shared.as<system_error>());
+        REQUIRE(wrapped.match_innermost<system_error>().index() == 1);
+
+        std::string out;
+        errors::format_to(out, wrapped, errors::format_style::located);
+        std::string expected;
+        errors::format_to(expected, shared.chain(),
+                          errors::format_style::located);
+        REQUIRE(out.size() > expected.size());
+        REQUIRE(out.compare(out.size() - expected.size(), expected.size(),
+                            expected) == 0);
+
+        shared = nullptr;
+        REQUIRE(wrapped.as<system_error>()->code == ENOENT);
+
+        wrapped = std::move(*wrapped).cause();
+        REQUIRE(wrapped.as<system_error>()->code == ENOENT);
+        REQUIRE(std::string(wrapped->what()) ==
+                std::string(wrapped.as<system_error>()->what()));
+}
+
+TEST_CASE("shared_error is not modified by trace", "[errors][shared_error]")
+{
+        shared_error shared =
+                errors::trace(errors::make<system_error>::with("open", ENOENT));
+        REQUIRE(shared.as<trace_error>()->size() == 1);
+        auto expected = to_string(shared.chain());
+
+        error_ptr err = shared;
+        err = errors::trace(std::move(err));
+        err = errors::trace(std::move(err));
+        REQUIRE(shared.as<trace_error>()->size() == 1);
+        REQUIRE(to_string(shared.chain()) == expected);
+        REQUIRE(err.as<trace_error>() != shared.as<trace_error>());
+        REQUIRE(err.as<trace_error>()->size() == 2);
+}
+
+TEST_CASE("shared_error is looked through for unregistered types",
+          "[errors][shared_error]")
+{
+        local_shared_error shared =
+                errors::wrap(errors::make<unregistered_error_t>::with(7));
+
+        error_ptr err = errors::wrap("outer", shared);
+        err = errors::wrap("again", errors::wrap(shared));
+        REQUIRE(shared.use_count() == 2);
+        REQUIRE(err.as<unregistered_error_t>()->value == 7);
+        REQUIRE(errors::chain_formatter<value_format>::formatted_size(err) ==
+                sizeof("again: value=7") - 1);
+
+        // NOTE:
+        // Moving causes out of references refers to the shared causes.
+        error_ptr cause = std::move(*err).cause();
+        cause = std::move(*cause).cause();
+        REQUIRE(cause.as<unregistered_error_t>() ==
+                shared.as<unregistered_error_t>());
+        cause = std::move(*cause).cause();
+        REQUIRE(cause.get() != shared.as<unregistered_error_t>());
+        REQUIRE(cause.as<unregistered_error_t>() ==
+                shared.as<unregistered_error_t>());
+        cause = std::move(*cause).cause();
+        REQUIRE(cause == nullptr);
+}
+
+TEST_CASE("shared_error can be copied by multiple threads",
+          "[errors][shared_error]")
+{
+        shared_error shared = errors::make<system_error>::with("open", ENOENT);
+        constexpr int threads = 4;
+        constexpr int rounds = 1000;
+
+        std::atomic<int> found = 0;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([shared, &found]() {
+                        for (int j = 0; j < rounds; ++j) {
+                                auto copy = shared;
+                                error_ptr err = errors::wrap("worker", copy);
+                                if (err.as<system_error>()->code == ENOENT) {
+                                        ++found;
+                                }
+                        }
+                });
+        }
+        for (auto &worker : workers) {
+                worker.join();
+        }
+
+        REQUIRE(found == threads * rounds);
+        REQUIRE(shared.use_count() == 1);
+}
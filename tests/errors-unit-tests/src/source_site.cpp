@@ -0,0 +1,68 @@
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::source_location;
+using ::errors::source_site;
+
+source_location here(source_location location = source_location::current())
+{
+        return location;
+}
+}
+
+TEST_CASE("source_site interns source locations", "[errors][source_site]")
+{
+        REQUIRE(source_site().id() == 0);
+        REQUIRE(!source_site().location().has_value());
+
+        std::vector<source_location> locations;
+        for (int i = 0; i < 2; ++i) {
+                locations.push_back(here());
+        }
+        locations.push_back(here());
+
+        source_site first(locations[0]);
+        REQUIRE(first.id() != 0);
+        REQUIRE(first == source_site(locations[1]));
+        REQUIRE(first != source_site(locations[2]));
+        REQUIRE(std::hash<source_site>()(first) ==
+                std::hash<source_site>()(source_site(locations[1])));
+
+        auto location = first.location();
+        REQUIRE(location.has_value());
+        REQUIRE(location->line() == locations[0].line());
+        REQUIRE(location->file_name() == locations[0].file_name());
+        REQUIRE(location->function_name() == locations[0].function_name());
+}
+
+TEST_CASE("source_site can be interned from many threads at once",
+          "[errors][source_site]")
+{
+        constexpr int thread_count = 8;
+        std::vector<std::vector<std::uint32_t>> ids(thread_count);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&ids, i]() {
+                        for (int j = 0; j < 100; ++j) {
+                                ids[i].push_back(source_site(here()).id());
+                                ids[i].push_back(source_site(here()).id());
+                        }
+                });
+        }
+        for (auto &thread : threads) {
+                thread.join();
+        }
+
+        std::unordered_set<std::uint32_t> unique;
+        for (const auto &list : ids) {
+                unique.insert(list.begin(), list.end());
+        }
+        REQUIRE(unique.size() == 2);
+        REQUIRE(unique.count(0) == 0);
+}
@@ -0,0 +1,197 @@
+#include <iterator>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+#include "to_string.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::runtime_error;
+using ::errors::impl::sampled_error;
+using ::errors::impl::system_error;
+using ::errors_unit_tests::to_string;
+using ::errors_unit_tests::to_located;
+
+class sampled_error_t : public runtime_error {
+        ERRORS_CLONEABLE(sampled_error_t);
+
+    public:
+        explicit sampled_error_t(source_location location)
+                : runtime_error("sampled", std::move(location))
+        {
+        }
+
+        sampled_error_t(const sampled_error_t &other, error_ptr &&cause)
+                : runtime_error(other, std::move(cause))
+        {
+        }
+};
+
+std::size_t count(const std::string &str, const std::string &pattern)
+{
+        std::size_t result = 0;
+        for (auto pos = str.find(pattern); pos != std::string::npos;
+             pos = str.find(pattern, pos + pattern.size())) {
+                ++result;
+        }
+        return result;
+}
+}
+
+TEST_CASE("stack traces are not recorded by default", "[errors][stacktrace]")
+{
+        error_ptr err = errors::make<sampled_error_t>::with();
+        REQUIRE(err.is<sampled_error_t>());
+        REQUIRE(errors::stacktrace_of(err) == nullptr);
+}
+
+TEST_CASE("sampled errors record stack traces", "[errors][stacktrace]")
+{
+        errors::sample_stacktraces<sampled_error_t>(1);
+
+        error_ptr err = errors::make<sampled_error_t>::with();
+        const auto line = source_location::current().line();
+        const auto *stack = errors::stacktrace_of(err);
+        REQUIRE(stack != nullptr);
+
+        // NOTE:
+        // The sampled error is still the outermost one.
+        REQUIRE(dynamic_cast<const sampled_error_t *>(err.get()) != nullptr);
+        REQUIRE(err.as<sampled_error_t>() == err.get());
+        REQUIRE(err->cause() == nullptr);
+        REQUIRE(err->location()->line() == line - 1);
+        REQUIRE(std::string(err->what()) == "sampled");
+        REQUIRE(to_string(err) == "sampled");
+
+        // NOTE:
+        // Other types are sampled by their own rates.
+        REQUIRE(errors::stacktrace_of(errors::make<system_error>::with(
+                        "open", ENOENT)) == nullptr);
+
+#if defined(ERRORS_HAS_EXECINFO)
+        REQUIRE(stack->size() != 0);
+        REQUIRE(stack->address(0) != nullptr);
+        REQUIRE(std::string(stack->symbol(0)).size() != 0);
+        REQUIRE(std::string(stack->symbol(stack->size())).empty());
+
+        auto located = to_located(err);
+        REQUIRE(count(located, "\n    #") == stack->size());
+        REQUIRE(located.find("] sampled\n    #0 ") != std::string::npos);
+
+        std::string json;
+        errors::write_json(json, err, errors::json_form::flat);
+        REQUIRE(count(json, "\"stacktrace\":[") == 1);
+        REQUIRE(json.find(stack->symbol(0)) != std::string::npos);
+#endif
+
+        errors::sample_stacktraces<sampled_error_t>(0);
+}
+
+TEST_CASE("sampled errors read like errors which are not sampled",
+          "[errors][stacktrace]")
+{
+        auto make = []() {
+                return errors::wrap(
+                        "read config",
+                        errors::make<system_error>::with("open", ENOENT));
+        };
+        error_ptr plain = make();
+        errors::sample_stacktraces<system_error>(1);
+        error_ptr sampled = make();
+        errors::sample_stacktraces<system_error>(0);
+
+        REQUIRE(errors::stacktrace_of(plain) == nullptr);
+        REQUIRE(errors::stacktrace_of(sampled) != nullptr);
+        REQUIRE(std::string(sampled->cause()->what()) ==
+                plain->cause()->what());
+        REQUIRE(sampled.as<system_error>()->code == ENOENT);
+        REQUIRE(to_string(sampled) == to_string(plain));
+
+        std::string plain_json;
+        std::string sampled_json;
+        errors::write_json(plain_json, plain, errors::json_form::flat);
+        errors::write_json(sampled_json, sampled, errors::json_form::flat);
+        REQUIRE(count(sampled_json, "\"message\"") ==
+                count(plain_json, "\"message\""));
+
+        std::string plain_wire;
+        std::string sampled_wire;
+        errors::write_binary(plain_wire, plain);
+        errors::write_binary(sampled_wire, sampled);
+        auto chain = errors::wire_chain::parse(sampled_wire);
+        REQUIRE(chain);
+        REQUIRE(chain->size() == errors::wire_chain::parse(plain_wire)->size());
+        REQUIRE(std::next(chain->begin())->tag == errors::wire_tag::system);
+        REQUIRE(std::next(chain->begin())->code == ENOENT);
+}
+
+TEST_CASE("stack traces are sampled one in N per thread",
+          "[errors][stacktrace]")
+{
+        errors::sample_stacktraces<sampled_error_t>(3);
+
+        int sampled = 0;
+        for (int i = 0; i < 9; ++i) {
+                error_ptr err = errors::make<sampled_error_t>::with();
+                if (errors::stacktrace_of(err) != nullptr) {
+                        ++sampled;
+                }
+        }
+        REQUIRE(sampled == 3);
+
+        errors::sample_stacktraces<sampled_error_t>(0);
+}
+
+TEST_CASE("stack traces can be cloned", "[errors][stacktrace]")
+{
+        errors::sample_stacktraces<sampled_error_t>(1);
+
+        error_ptr err =
+                errors::wrap("wrap", errors::make<sampled_error_t>::with());
+        auto copy = errors::clone(err);
+        const auto *stack = errors::stacktrace_of(err);
+        const auto *copied = errors::stacktrace_of(copy);
+
+        REQUIRE(copied != nullptr);
+        REQUIRE(copied != stack);
+        REQUIRE(copied->size() == stack->size());
+        for (std::size_t i = 0; i < stack->size(); ++i) {
+                REQUIRE(copied->address(i) == stack->address(i));
+        }
+        REQUIRE(copy.as<sampled_error_t>() != nullptr);
+        REQUIRE(to_string(copy) == "wrap: sampled");
+        REQUIRE(to_located(copy) == to_located(err));
+
+        errors::sample_stacktraces<sampled_error_t>(0);
+}
+
+#if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
+
+#include "nlohmann/json.hpp"
+
+TEST_CASE("to_json writes stack traces", "[errors][json][stacktrace]")
+{
+        errors::sample_stacktraces<sampled_error_t>(1);
+
+        error_ptr err =
+                errors::wrap("wrap", errors::make<sampled_error_t>::with());
+        const auto *stack = errors::stacktrace_of(err);
+
+        nlohmann::json j = err;
+        REQUIRE(j["caused_by"]["message"] == "sampled");
+        REQUIRE(j["caused_by"]["stacktrace"].size() == stack->size());
+        REQUIRE(j["caused_by"]["caused_by"].is_null());
+
+        std::string written;
+        errors::write_json(written, err);
+        REQUIRE(written == j.dump());
+        REQUIRE(errors::flat_json(err)[1]["stacktrace"] ==
+                j["caused_by"]["stacktrace"]);
+
+        errors::sample_stacktraces<sampled_error_t>(0);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include "errors/detail/errno_message.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::system_error;
+
+std::string expected_what(int code)
+{
+        return errors::detail::strerror_string(code) + " [code=" +
+               std::to_string(code) + "]";
+}
+}
+
+TEST_CASE("errno messages are looked up from the table",
+          "[errors][system_error]")
+{
+        using Catch::Matchers::Equals;
+
+        const auto &messages = errors::detail::errno_messages::instance();
+        REQUIRE(messages.find(ENOENT) == std::strerror(ENOENT));
+        REQUIRE(messages.find(EAGAIN) == std::strerror(EAGAIN));
+        REQUIRE(messages.find(-1).empty());
+        REQUIRE(messages.find(errors::detail::errno_messages::size).empty());
+
+        auto err = errors::make<system_error>::with(-1);
+        REQUIRE_THAT(err->what(), Equals(expected_what(-1)));
+}
+
+TEST_CASE("system_error can be created from many threads at once",
+          "[errors][system_error]")
+{
+        const std::vector<int> codes = { EAGAIN, ECONNRESET, ENOENT, 9999 };
+        std::vector<std::string> expected;
+        for (auto code : codes) {
+                expected.push_back(expected_what(code));
+        }
+
+        const error_ptr shared = errors::make<system_error>::with(EAGAIN);
+        const auto &messages = errors::detail::errno_messages::instance();
+
+        constexpr int thread_count = 8;
+        constexpr int iterations = 2000;
+        std::vector<int> failures(thread_count);
+        std::vector<const char *> shared_whats(thread_count);
+        // NOTE:
+        // The message cached for a code is published once,
+        // every thread must see the same string on every call.
+        std::vector<std::vector<const char *>> cached(
+                thread_count, std::vector<const char *>(codes.size()));
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&, i]() {
+                        shared_whats[i] = shared->what();
+                        for (int j = 0; j < iterations; ++j) {
+                                auto index = static_cast<std::size_t>(
+                                        (i + j) % codes.size());
+                                errno = codes[index];
+                                auto err = errors::make<system_error>::with(
+                                        "op");
+                                if (err.as<system_error>()->code !=
+                                            codes[index] ||
+                                    "op: " + expected[index] != err->what()) {
+                                        ++failures[i];
+                                }
+
+                                const auto *message =
+                                        messages.find(codes[index]).data();
+                                if (j < static_cast<int>(codes.size())) {
+                                        cached[i][index] = message;
+                                } else if (cached[i][index] != message) {
+                                        ++failures[i];
+                                }
+                        }
+                });
+        }
+        for (auto &thread : threads) {
+                thread.join();
+        }
+
+        for (int i = 0; i < thread_count; ++i) {
+                REQUIRE(failures[i] == 0);
+                REQUIRE(shared_whats[i] == shared_whats[0]);
+                for (std::size_t j = 0; j < codes.size(); ++j) {
+                        REQUIRE(cached[i][j] == messages.find(codes[j]).data());
+                }
+        }
+        REQUIRE(expected[0] == shared->what());
+}
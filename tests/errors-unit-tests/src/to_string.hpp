@@ -0,0 +1,30 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+#include "errors/error_ptr.hpp"
+#include "errors/format.hpp"
+
+namespace errors_unit_tests
+{
+
+/// @brief
+/// Print an error chain with operator<<.
+inline std::string to_string(const ::errors::error_ptr &err)
+{
+        std::ostringstream os;
+        os << err;
+        return os.str();
+}
+
+/// @brief
+/// Print an error chain with ::errors::format_style::located.
+inline std::string to_located(const ::errors::error_ptr &err)
+{
+        std::string result;
+        ::errors::format_to(result, err, ::errors::format_style::located);
+        return result;
+}
+
+}
@@ -0,0 +1,98 @@
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::impl::runtime_error;
+using ::errors::impl::trace_error;
+using ::errors::impl::wrap_error;
+
+std::size_t chain_length(const error_ptr &err)
+{
+        std::size_t length = 0;
+        for (const auto *current = err.get(); current != nullptr;
+             current = current->cause().get()) {
+                ++length;
+        }
+        return length;
+}
+}
+
+TEST_CASE("trace records frames without allocating for each of them",
+          "[errors][trace]")
+{
+        REQUIRE(errors::trace(nullptr) == nullptr);
+
+        error_ptr err = errors::make<runtime_error>::with("error");
+        const auto line = errors::source_location::current().line();
+        for (int i = 0; i < 20; ++i) {
+                err = errors::trace(std::move(err));
+        }
+
+        // NOTE:
+        // 20 frames take 3 trace_error.
+        REQUIRE(chain_length(err) == 4);
+        REQUIRE(err.as<trace_error>()->size() == 4);
+        REQUIRE(err->cause().as<trace_error>()->size() ==
+                trace_error::capacity);
+        REQUIRE(err->location()->line() == line + 2);
+        REQUIRE(err.as<trace_error>()->frame(3).line() == line + 2);
+
+        err = errors::wrap("wrap", std::move(err));
+        err = errors::trace(std::move(err));
+        REQUIRE(chain_length(err) == 6);
+
+        std::stringstream ss;
+        ss << err;
+        REQUIRE_THAT(ss.str(), Catch::Matchers::Equals("wrap: error"));
+}
+
+TEST_CASE("wrap does not copy errors::literal", "[errors][trace]")
+{
+        constexpr auto message = ERRORS_LITERAL("failed to read config");
+
+        error_ptr err = errors::make<runtime_error>::with("error");
+        err = errors::wrap(message, std::move(err));
+        REQUIRE(err.is<wrap_error>());
+        REQUIRE(err->what() == message.c_str());
+
+        err = errors::wrap(message.c_str(), std::move(err));
+        REQUIRE(err->what() != message.c_str());
+        REQUIRE_THAT(err->what(), Catch::Matchers::Equals(message.c_str()));
+
+        char buffer[] = "buffer";
+        err = errors::wrap(buffer, std::move(err));
+        buffer[0] = 'B';
+        REQUIRE_THAT(err->what(), Catch::Matchers::Equals("buffer"));
+
+        REQUIRE(errors::wrap("message", nullptr) == nullptr);
+}
+
+#if defined(ERRORS_ENABLE_NLOHMANN_JSON_SUPPORT)
+
+#include "nlohmann/json.hpp"
+
+TEST_CASE("to_json expands frames of trace_error", "[errors][json][trace]")
+{
+        error_ptr err = errors::make<runtime_error>::with("error");
+        for (int i = 0; i < 10; ++i) {
+                err = errors::trace(std::move(err));
+        }
+
+        nlohmann::json j = err;
+        const auto *node = &j;
+        for (int i = 0; i < 10; ++i) {
+                REQUIRE((*node)["message"] == "");
+                REQUIRE((*node)["location"]["line"] ==
+                        err->location()->line());
+                node = &(*node)["caused_by"];
+        }
+        REQUIRE((*node)["message"] == "error");
+        REQUIRE((*node)["caused_by"].is_null());
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::source_location;
+using ::errors::impl::code_error;
+using ::errors::impl::exception_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+using ::errors::impl::wrap_error;
+
+class registered_error_t : public wrap_error {
+        ERRORS_REGISTER_TYPE(registered_error_t, wrap_error);
+
+    public:
+        registered_error_t(int depth, error_ptr &&cause,
+                           source_location location)
+                : wrap_error(std::move(cause), std::move(location))
+                , depth(depth)
+        {
+        }
+
+        int depth;
+};
+
+class derived_error_t : public registered_error_t {
+    public:
+        using registered_error_t::registered_error_t;
+};
+
+class interface_t : public virtual errors::error {
+        ERRORS_REGISTER_TYPE(interface_t);
+
+    public:
+        virtual int value() const noexcept = 0;
+};
+
+class multiple_error_t : public runtime_error, public interface_t {
+        ERRORS_REGISTER_TYPE(multiple_error_t, runtime_error, interface_t);
+
+    public:
+        explicit multiple_error_t(source_location location)
+                : runtime_error("multiple", std::move(location))
+        {
+        }
+
+        int value() const noexcept override
+        {
+                return 42;
+        }
+};
+}
+
+TEST_CASE("builtin error types are registered", "[errors][type_id]")
+{
+        STATIC_REQUIRE(errors::is_registered_v<runtime_error>);
+        STATIC_REQUIRE(errors::is_registered_v<code_error<int>>);
+        STATIC_REQUIRE(errors::is_registered_v<system_error>);
+        STATIC_REQUIRE(errors::is_registered_v<exception_error>);
+        STATIC_REQUIRE(errors::is_registered_v<wrap_error>);
+        STATIC_REQUIRE(!errors::is_registered_v<errors::impl::base_error>);
+        REQUIRE(errors::type_id_of<code_error<int>>() !=
+                errors::type_id_of<code_error<unsigned int>>());
+
+        error_ptr err = errors::make<system_error>::with("open", ENOENT);
+        err = errors::wrap("wrap", std::move(err));
+
+        REQUIRE(err.is<wrap_error>());
+        REQUIRE(err.is<system_error>());
+        REQUIRE(err.is<code_error<int>>());
+        REQUIRE(err.is<runtime_error>());
+        REQUIRE(!err.is<code_error<unsigned int>>());
+        REQUIRE(!err.is<exception_error>());
+
+        REQUIRE(err.as<wrap_error>() == dynamic_cast<wrap_error *>(err.get()));
+        REQUIRE(err.as<code_error<int>>()->code == ENOENT);
+        REQUIRE(err.as<runtime_error>() == err.as<system_error>());
+        REQUIRE(errors::as<system_error>(*err)->code == ENOENT);
+        REQUIRE(errors::is<runtime_error>(*err));
+}
+
+TEST_CASE("user defined error types can be registered", "[errors][type_id]")
+{
+        STATIC_REQUIRE(errors::is_registered_v<registered_error_t>);
+        STATIC_REQUIRE(!errors::is_registered_v<derived_error_t>);
+
+        error_ptr err = errors::make<runtime_error>::with("error");
+        err = errors::make<registered_error_t>::with(1, std::move(err));
+        err = errors::make<derived_error_t>::with(2, std::move(err));
+
+        REQUIRE(err.is<derived_error_t>());
+        REQUIRE(err.as<registered_error_t>()->depth == 2);
+        REQUIRE(err.as<wrap_error>() ==
+                static_cast<wrap_error *>(err.as<registered_error_t>()));
+        REQUIRE(err.as<runtime_error>() != nullptr);
+
+        err = errors::wrap(std::move(*err).cause());
+        REQUIRE(!err.is<derived_error_t>());
+        REQUIRE(err.as<registered_error_t>()->depth == 1);
+}
+
+TEST_CASE("error types with multiple bases can be registered",
+          "[errors][type_id]")
+{
+        error_ptr err = errors::wrap(errors::make<multiple_error_t>::with());
+
+        REQUIRE(err.is<interface_t>());
+        REQUIRE(err.as<interface_t>()->value() == 42);
+        REQUIRE(err.as<interface_t>() ==
+                dynamic_cast<const interface_t *>(err->cause().get()));
+        REQUIRE(err.as<runtime_error>() ==
+                dynamic_cast<const runtime_error *>(err->cause().get()));
+        REQUIRE(err.as<multiple_error_t>() ==
+                dynamic_cast<const multiple_error_t *>(err->cause().get()));
+}
+
+TEST_CASE("registered bases are all listed", "[errors][type_id]")
+{
+        using errors::detail::lists_registered_bases;
+
+        STATIC_REQUIRE(lists_registered_bases<runtime_error>());
+        STATIC_REQUIRE(
+                lists_registered_bases<system_error, code_error<int>>());
+        STATIC_REQUIRE(!lists_registered_bases<system_error>());
+        STATIC_REQUIRE(!lists_registered_bases<system_error, runtime_error>());
+        STATIC_REQUIRE(lists_registered_bases<multiple_error_t, runtime_error,
+                                              interface_t>());
+        STATIC_REQUIRE(!lists_registered_bases<multiple_error_t,
+                                               runtime_error>());
+}
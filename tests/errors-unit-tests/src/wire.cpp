@@ -0,0 +1,227 @@
+#include <cerrno>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "errors/errors.hpp"
+
+namespace
+{
+using ::errors::error_ptr;
+using ::errors::wire_chain;
+using ::errors::wire_tag;
+using ::errors::impl::code_error;
+using ::errors::impl::runtime_error;
+using ::errors::impl::system_error;
+
+error_ptr fn(int depth)
+{
+        if (depth == 0) {
+                return errors::make<system_error>::with("open", ENOENT);
+        }
+        if (depth % 2 == 0) {
+                return errors::trace(fn(depth - 1));
+        }
+        return errors::wrap("depth=" + std::to_string(depth), fn(depth - 1));
+}
+
+std::string to_binary(const error_ptr &err)
+{
+        std::string result;
+        errors::write_binary(result, err);
+        return result;
+}
+
+std::string format(const error_ptr &err, errors::format_style style)
+{
+        std::string result;
+        errors::format_to(result, err, style);
+        return result;
+}
+
+bool within(std::string_view view, const std::string &buffer)
+{
+        return view.data() >= buffer.data() &&
+               view.data() + view.size() <= buffer.data() + buffer.size();
+}
+}
+
+TEST_CASE("write_binary writes null error", "[errors][wire]")
+{
+        auto buffer = to_binary(nullptr);
+        auto chain = wire_chain::parse(buffer);
+        REQUIRE(chain);
+        REQUIRE(chain->empty());
+        REQUIRE(chain->begin() == chain->end());
+        REQUIRE(chain->encoded_size() == buffer.size());
+        REQUIRE(chain->to_error() == nullptr);
+}
+
+TEST_CASE("wire_chain views records in the buffer", "[errors][wire]")
+{
+        auto err = fn(4);
+        auto buffer = to_binary(err);
+        auto chain = wire_chain::parse(buffer);
+        REQUIRE(chain);
+
+        std::vector<wire_tag> tags;
+        for (const auto &record : *chain) {
+                tags.push_back(record.tag);
+                REQUIRE(record.has_location);
+                REQUIRE(within(record.file_name, buffer));
+                REQUIRE(within(record.message, buffer));
+        }
+        REQUIRE(tags == std::vector<wire_tag>{ wire_tag::trace, wire_tag::wrap,
+                                               wire_tag::trace, wire_tag::wrap,
+                                               wire_tag::system });
+        REQUIRE(chain->size() == 5);
+
+        auto innermost = *std::next(chain->begin(), 4);
+        REQUIRE(innermost.has_code);
+        REQUIRE(innermost.code == ENOENT);
+        REQUIRE(innermost.message == "open");
+        REQUIRE(std::string(innermost.file_name) ==
+                errors::source_location::current().file_name());
+}
+
+TEST_CASE("wire_chain round trips errors", "[errors][wire]")
+{
+        auto err = fn(6);
+        auto buffer = to_binary(err);
+        auto chain = wire_chain::parse(buffer);
+        REQUIRE(chain);
+
+        auto copy = chain->to_error();
+        REQUIRE(format(copy, errors::format_style::chain) ==
+                format(err, errors::format_style::chain));
+#if !defined(ERRORS_USE_STD_SOURCE_LOCATION)
+        REQUIRE(format(copy, errors::format_style::located) ==
+                format(err, errors::format_style::located));
+#endif
+
+        const auto *system = copy.as<system_error>();
+        REQUIRE(system != nullptr);
+        REQUIRE(system->code == ENOENT);
+
+        buffer = to_binary(
+                errors::make<code_error<int>>::with("bad request", -400));
+        auto coded = wire_chain::parse(buffer);
+        REQUIRE(coded);
+        auto copied = coded->to_error();
+        REQUIRE(copied.as<system_error>() == nullptr);
+        REQUIRE(copied.as<code_error<int>>()->code == -400);
+        REQUIRE(std::string(copied->what()) ==
+                errors::make<code_error<int>>::with("bad request", -400)
+                        ->what());
+}
+
+TEST_CASE("wire_chain keeps what of other errors", "[errors][wire]")
+{
+        errors::batch batch;
+        batch.add(errors::make<runtime_error>::with("first"));
+        batch.add(errors::make<runtime_error>::with("second"));
+        error_ptr err = errors::join("bulk write", std::move(batch));
+        std::string what = err->what();
+
+        auto buffer = to_binary(errors::wrap("flush", std::move(err)));
+        auto chain = wire_chain::parse(buffer);
+        REQUIRE(chain);
+        REQUIRE(chain->size() == 2);
+        REQUIRE(std::next(chain->begin())->tag == wire_tag::other);
+        REQUIRE(std::next(chain->begin())->message == what);
+
+        auto copy = chain->to_error();
+        REQUIRE(copy.as<runtime_error>() != nullptr);
+        REQUIRE(format(copy, errors::format_style::chain) ==
+                "flush: " + what);
+}
+
+TEST_CASE("wire_chain keeps system_error without a message",
+          "[errors][wire]")
+{
+        auto err = errors::make<system_error>::with(ENOENT);
+        auto buffer = to_binary(err);
+        auto chain = wire_chain::parse(buffer);
+        REQUIRE(chain);
+
+        auto copy = chain->to_error();
+        REQUIRE(copy.as<system_error>()->code == ENOENT);
+        REQUIRE(std::string(copy->what()) == err->what());
+}
+
+TEST_CASE("wire_strings is bounded", "[errors][wire]")
+{
+        errors::detail::wire_strings strings(8);
+        const auto *name = strings.intern("main");
+        REQUIRE(name != nullptr);
+        REQUIRE(std::string(name) == "main");
+        REQUIRE(strings.intern(std::string("main")) == name);
+
+        // NOTE:
+        // "main" and "fn" take 5 and 3 bytes with their terminators.
+        REQUIRE(strings.intern("fn") != nullptr);
+        REQUIRE(strings.intern("x") == nullptr);
+        REQUIRE(strings.intern("main") == name);
+}
+
+TEST_CASE("wire_chain bounds the depth of chains", "[errors][wire]")
+{
+        error_ptr err = errors::make<runtime_error>::with("innermost");
+        for (int i = 0; i < 2000; ++i) {
+                err = errors::wrap("wrap", std::move(err));
+        }
+        auto buffer = to_binary(err);
+
+        REQUIRE_FALSE(wire_chain::parse(buffer));
+        auto chain = wire_chain::parse(buffer, 4096);
+        REQUIRE(chain);
+        REQUIRE(chain->size() == 2001);
+
+        auto depth_of = [](const error_ptr &chain) {
+                std::size_t depth = 0;
+                for (const auto *current = chain.get(); current != nullptr;
+                     current = current->cause().get()) {
+                        ++depth;
+                }
+                return depth;
+        };
+
+        auto copy = chain->to_error();
+        REQUIRE(depth_of(copy) == wire_chain::default_max_depth);
+        REQUIRE(copy.as<runtime_error>() != nullptr);
+        REQUIRE(depth_of(chain->to_error(10)) == 10);
+        REQUIRE(format(chain->to_error(2), errors::format_style::chain) ==
+                "wrap: wrap");
+}
+
+TEST_CASE("wire_chain rejects malformed buffers", "[errors][wire]")
+{
+        auto buffer = to_binary(fn(3));
+
+        // NOTE:
+        // Trailing data is not part of the chain.
+        auto chain = wire_chain::parse(buffer + "trailing");
+        REQUIRE(chain);
+        REQUIRE(chain->encoded_size() == buffer.size());
+
+        for (std::size_t size = 0; size < buffer.size(); ++size) {
+                REQUIRE_FALSE(
+                        wire_chain::parse(std::string_view(buffer).substr(
+                                0, size)));
+        }
+
+        auto bad = buffer;
+        bad[0] = 'x';
+        REQUIRE_FALSE(wire_chain::parse(bad));
+
+        bad = buffer;
+        bad[3] = '\x7f';
+        REQUIRE_FALSE(wire_chain::parse(bad));
+
+        REQUIRE_FALSE(wire_chain::parse(std::string("\xE7\x01\xFF\xFF\xFF\xFF"
+                                                    "\xFF\xFF\xFF\xFF\xFF\xFF"
+                                                    "\x01",
+                                                    13)));
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+# compare-benchmarks.py - Compare results of errors-benchmarks with a baseline.
+#
+# Both files are JSON files written by google/benchmark with
+# `--benchmark_out=<file> --benchmark_out_format=json`.
+#
+# Allocation counters (allocs/op and bytes/op) are deterministic,
+# so any increase of them is reported as a regression.
+# Timings are noisy, so they are only checked
+# when --time-threshold is given.
+
+import argparse
+import json
+import sys
+
+COUNTERS = ["allocs/op", "bytes/op"]
+
+
+def load(path):
+    with open(path, "r") as f:
+        data = json.load(f)
+
+    results = {}
+    for benchmark in data.get("benchmarks", []):
+        if benchmark.get("run_type", "iteration") != "iteration":
+            continue
+        results[benchmark["name"]] = benchmark
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare results of errors-benchmarks with a baseline.")
+    parser.add_argument("baseline", help="path to the baseline JSON file")
+    parser.add_argument("current", help="path to the current JSON file")
+    parser.add_argument(
+        "--time-threshold",
+        type=float,
+        default=None,
+        metavar="RATIO",
+        help="report cpu_time increased more than RATIO (e.g. 0.1) "
+        "as a regression")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    for name, result in sorted(current.items()):
+        if name not in baseline:
+            print("new:        {0}".format(name))
+            continue
+
+        base = baseline[name]
+        for counter in COUNTERS:
+            if counter not in base or counter not in result:
+                continue
+            # NOTE:
+            # One-time allocations (e.g. buffer growth of a reused stream)
+            # are averaged over a number of iterations which depends on
+            # the speed of the machine, so ignore differences less than
+            # half an allocation or half a byte per operation.
+            if result[counter] > base[counter] + 0.5:
+                regressions.append("{0}: {1} {2} -> {3}".format(
+                    name, counter, base[counter], result[counter]))
+
+        if args.time_threshold is not None:
+            limit = base["cpu_time"] * (1 + args.time_threshold)
+            if result["cpu_time"] > limit:
+                regressions.append("{0}: cpu_time {1:.1f} -> {2:.1f} {3}".format(
+                    name, base["cpu_time"], result["cpu_time"],
+                    result.get("time_unit", "ns")))
+
+    for name in sorted(set(baseline) - set(current)):
+        print("missing:    {0}".format(name))
+
+    for regression in regressions:
+        print("regression: {0}".format(regression))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())